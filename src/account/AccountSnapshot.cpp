@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "AccountSnapshot.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace banking {
+// unnamed namespace for helpers with internal linkage
+namespace {
+constexpr std::uint64_t columnAlignment = 64;
+constexpr std::uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+constexpr std::uint64_t fnvPrime = 1099511628211ULL;
+
+// round an offset up to the next column alignment
+std::uint64_t alignColumn(std::uint64_t offset) { return (offset + columnAlignment - 1) / columnAlignment * columnAlignment; }
+
+// continue a FNV-1a checksum over a block of bytes
+std::uint64_t checksum(const void *data, size_t size, std::uint64_t hash = fnvOffsetBasis) {
+    auto bytes = static_cast<const unsigned char *>(data);
+
+    for (size_t index = 0; index < size; index++) {
+        hash = (hash ^ bytes[index]) * fnvPrime;
+    }
+
+    return hash;
+}
+
+// write a column buffer at its position in the file and continue the column checksum
+template <typename T>
+void writeColumn(std::ofstream &file, std::uint64_t offset, const std::vector<T> &column, std::uint64_t &columnChecksum) {
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(reinterpret_cast<const char *>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+    columnChecksum = checksum(column.data(), column.size() * sizeof(T), columnChecksum);
+}
+
+// check that a column of 'count' elements lies completely within the mapped file
+bool columnFits(std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize, std::uint64_t fileSize) {
+    return offset % columnAlignment == 0 && (count == 0 || (count <= fileSize / elementSize && offset <= fileSize - count * elementSize));
+}
+
+// map a whole file read-only into memory
+const std::byte *mapFile(const std::string &path, size_t &size) {
+#if defined(_WIN32)
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("cannot open account snapshot " + path);
+    }
+
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(file, &fileSize);
+    size = static_cast<size_t>(fileSize.QuadPart);
+    auto mapping = size > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    auto view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+    // the view keeps the mapping alive after its handles are closed
+    if (mapping != nullptr) {
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(file);
+
+    if (view == nullptr) {
+        throw std::runtime_error("cannot map account snapshot " + path);
+    }
+
+    return static_cast<const std::byte *>(view);
+#else
+    auto file = open(path.c_str(), O_RDONLY);
+
+    if (file < 0) {
+        throw std::runtime_error("cannot open account snapshot " + path);
+    }
+
+    struct stat status{};
+
+    if (fstat(file, &status) != 0) {
+        close(file);
+        throw std::runtime_error("cannot determine size of account snapshot " + path);
+    }
+
+    size = static_cast<size_t>(status.st_size);
+    auto view = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+
+    // the mapping stays valid after the file descriptor is closed
+    close(file);
+
+    if (view == MAP_FAILED) {
+        throw std::runtime_error("cannot map account snapshot " + path);
+    }
+
+    return static_cast<const std::byte *>(view);
+#endif
+}
+
+// unmap a file that was mapped by mapFile
+void unmapFile(const std::byte *view, [[maybe_unused]] size_t size) {
+#if defined(_WIN32)
+    UnmapViewOfFile(view);
+#else
+    munmap(const_cast<std::byte *>(view), size);
+#endif
+}
+} // namespace
+
+// constructor and methods for AccountSnapshotWriter
+AccountSnapshotWriter::AccountSnapshotWriter(const std::string &path, std::uint64_t count)
+    : file{path, std::ios::binary | std::ios::out | std::ios::trunc} {
+    if (!file) {
+        throw std::runtime_error("cannot create account snapshot " + path);
+    }
+
+    header.version = SnapshotHeader::currentVersion;
+    header.byteOrder = SnapshotHeader::nativeByteOrder;
+    header.count = count;
+    header.flags = SnapshotHeader::sortedIds;
+    header.idOffset = alignColumn(sizeof(SnapshotHeader));
+    header.balanceOffset = alignColumn(header.idOffset + count * sizeof(std::int32_t));
+    header.interestRateOffset = alignColumn(header.balanceOffset + count * sizeof(double));
+    header.idChecksum = header.balanceChecksum = header.interestRateChecksum = fnvOffsetBasis;
+
+    // placeholder without magic until the snapshot is complete
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    ids.reserve(bufferedAccounts);
+    balances.reserve(bufferedAccounts);
+    interestRates.reserve(bufferedAccounts);
+}
+
+void AccountSnapshotWriter::append(int id, double balance, double interestRate) {
+    if (appended == header.count) {
+        throw std::runtime_error("account snapshot already contains all accounts");
+    }
+
+    if (lastId && id <= *lastId) {
+        header.flags &= ~SnapshotHeader::sortedIds;
+    }
+
+    lastId = id;
+    ids.push_back(id);
+    balances.push_back(balance);
+    interestRates.push_back(interestRate);
+    appended++;
+
+    if (ids.size() == bufferedAccounts) {
+        flush();
+    }
+}
+
+void AccountSnapshotWriter::append(const IAccount &account, double interestRate) { append(account.getId(), account.getBalance(), interestRate); }
+
+void AccountSnapshotWriter::finish() {
+    flush();
+
+    if (appended != header.count) {
+        throw std::runtime_error("account snapshot is incomplete");
+    }
+
+    std::memcpy(header.magic, SnapshotHeader::expectedMagic, sizeof(header.magic));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.flush();
+
+    if (!file) {
+        throw std::runtime_error("cannot write account snapshot");
+    }
+
+    file.close();
+}
+
+void AccountSnapshotWriter::flush() {
+    if (ids.empty()) {
+        return;
+    }
+
+    writeColumn(file, header.idOffset + flushed * sizeof(std::int32_t), ids, header.idChecksum);
+    writeColumn(file, header.balanceOffset + flushed * sizeof(double), balances, header.balanceChecksum);
+    writeColumn(file, header.interestRateOffset + flushed * sizeof(double), interestRates, header.interestRateChecksum);
+    flushed += ids.size();
+
+    ids.clear();
+    balances.clear();
+    interestRates.clear();
+}
+
+// constructor, destructor, and methods for AccountSnapshot
+AccountSnapshot::AccountSnapshot(const std::string &path) {
+    mapped = mapFile(path, mappedSize);
+
+    auto fail = [this, &path](const std::string &reason) {
+        unmapFile(mapped, mappedSize);
+        throw std::runtime_error("invalid account snapshot " + path + ": " + reason);
+    };
+
+    if (mappedSize < sizeof(SnapshotHeader)) {
+        fail("file too small");
+    }
+
+    std::memcpy(&header, mapped, sizeof(header));
+
+    if (std::memcmp(header.magic, SnapshotHeader::expectedMagic, sizeof(header.magic)) != 0) {
+        fail("bad magic");
+    }
+
+    if (header.version != SnapshotHeader::currentVersion) {
+        fail("unsupported version " + std::to_string(header.version));
+    }
+
+    if (header.byteOrder != SnapshotHeader::nativeByteOrder) {
+        fail("foreign byte order");
+    }
+
+    if (!columnFits(header.idOffset, header.count, sizeof(std::int32_t), mappedSize) ||
+        !columnFits(header.balanceOffset, header.count, sizeof(double), mappedSize) ||
+        !columnFits(header.interestRateOffset, header.count, sizeof(double), mappedSize)) {
+        fail("column out of bounds");
+    }
+}
+
+AccountSnapshot::~AccountSnapshot() { unmapFile(mapped, mappedSize); }
+
+size_t AccountSnapshot::size() const { return static_cast<size_t>(header.count); }
+
+std::span<const std::int32_t> AccountSnapshot::ids() const {
+    return {reinterpret_cast<const std::int32_t *>(mapped + header.idOffset), static_cast<size_t>(header.count)};
+}
+
+std::span<const double> AccountSnapshot::balances() const {
+    return {reinterpret_cast<const double *>(mapped + header.balanceOffset), static_cast<size_t>(header.count)};
+}
+
+std::span<const double> AccountSnapshot::interestRates() const {
+    return {reinterpret_cast<const double *>(mapped + header.interestRateOffset), static_cast<size_t>(header.count)};
+}
+
+std::optional<size_t> AccountSnapshot::find(int id) const {
+    auto column = ids();
+    auto found = (header.flags & SnapshotHeader::sortedIds) != 0 ? std::ranges::lower_bound(column, id) : std::ranges::find(column, id);
+
+    if (found == column.end() || *found != id) {
+        return std::nullopt;
+    }
+
+    return static_cast<size_t>(found - column.begin());
+}
+
+double AccountSnapshot::balance(size_t index) const {
+    auto found = overlay.find(index);
+    return found == overlay.end() ? balances()[index] : found->second.getBalance();
+}
+
+Account AccountSnapshot::account(size_t index) const { return Account{ids()[index], balance(index)}; }
+
+SavingsAccount AccountSnapshot::savingsAccount(size_t index, std::shared_ptr<const InterestIndex> interestIndex) const {
+    return SavingsAccount{ids()[index], balance(index), interestRates()[index], std::move(interestIndex)};
+}
+
+Account &AccountSnapshot::modify(size_t index) { return overlay.try_emplace(index, ids()[index], balances()[index]).first->second; }
+
+size_t AccountSnapshot::modified() const { return overlay.size(); }
+
+bool AccountSnapshot::verify() const {
+    return checksum(ids().data(), ids().size_bytes()) == header.idChecksum && checksum(balances().data(), balances().size_bytes()) == header.balanceChecksum &&
+           checksum(interestRates().data(), interestRates().size_bytes()) == header.interestRateChecksum;
+}
+} // namespace banking
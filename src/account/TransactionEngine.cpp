@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "TransactionEngine.h"
+
+namespace banking {
+// constructor and destructor for TransactionEngine
+TransactionEngine::TransactionEngine(size_t partitionCount) {
+    auto &registry = metrics::Registry::instance();
+    constexpr const char *help = "Commands completed by the transaction engine";
+    completedCommands = {&registry.counter("banking_transactions_total", help, "status=\"completed\""),
+                         &registry.counter("banking_transactions_total", help, "status=\"unknown_account\""),
+                         &registry.counter("banking_transactions_total", help, "status=\"account_exists\""),
+                         &registry.counter("banking_transactions_total", help, "status=\"stopped\"")};
+
+    // reserve may allocate more capacity than requested, so the partition count is fixed up front
+    auto count = std::max<size_t>(partitionCount, 1);
+    partitionList.reserve(count);
+
+    for (size_t index = 0; index < count; index++) {
+        partitionList.push_back(std::make_unique<Partition>());
+    }
+
+    // workers send messages to other partitions, so they start after all partitions exist
+    for (auto &partition : partitionList) {
+        partition->worker = std::jthread{[this, &partition = *partition] { run(partition); }};
+    }
+}
+
+TransactionEngine::~TransactionEngine() {
+    // a transfer sends messages between workers until it completes, so all queues stay open until every command completed
+    for (auto pending = pendingCommands.load(std::memory_order_acquire); pending != 0; pending = pendingCommands.load(std::memory_order_acquire)) {
+        pendingCommands.wait(pending, std::memory_order_acquire);
+    }
+
+    for (auto &partition : partitionList) {
+        partition->commands.finishProducer(0);
+    }
+
+    for (auto &partition : partitionList) {
+        partition->worker.join();
+    }
+}
+
+// public commands for TransactionEngine
+std::future<TransactionResult> TransactionEngine::open(int id, double balance) { return submit(Operation::Open, id, id, balance); }
+std::future<TransactionResult> TransactionEngine::deposit(int id, double amount) { return submit(Operation::Deposit, id, id, amount); }
+std::future<TransactionResult> TransactionEngine::withdraw(int id, double amount) { return submit(Operation::Withdraw, id, id, amount); }
+std::future<TransactionResult> TransactionEngine::transfer(int fromId, int toId, double amount) { return submit(Operation::Debit, fromId, toId, amount); }
+std::future<TransactionResult> TransactionEngine::balance(int id) { return submit(Operation::Balance, id, id, 0.0); }
+
+size_t TransactionEngine::partitions() const { return partitionList.size(); }
+
+// multiplicative hashing spreads consecutive ids across partitions, the high bits of the hash select the partition
+size_t TransactionEngine::partitionOf(int id) const {
+    auto hash = static_cast<std::uint32_t>(static_cast<std::uint32_t>(id) * 2654435761U);
+    return static_cast<size_t>((static_cast<std::uint64_t>(hash) * partitionList.size()) >> 32);
+}
+
+// message passing for TransactionEngine
+std::future<TransactionResult> TransactionEngine::submit(Operation operation, int id, int counterpartId, double amount) {
+    Command command{operation, id, counterpartId, amount, 0.0, {}};
+    auto result = command.result.get_future();
+    pendingCommands.fetch_add(1, std::memory_order_relaxed);
+    send(std::move(command));
+    return result;
+}
+
+void TransactionEngine::send(Command &&command) {
+    // a queue that does not take the command leaves it unmoved, which only happens for commands submitted during destruction
+    if (partitionList[partitionOf(command.id)]->commands.produce(std::move(command)) == producer_consumer::ProducerResult::Cancelled) {
+        complete(command, {TransactionStatus::Stopped, 0.0});
+    }
+}
+
+void TransactionEngine::complete(Command &command, TransactionResult result) {
+    command.result.set_value(result);
+    completedCommands[static_cast<size_t>(result.status)]->increment();
+
+    if (pendingCommands.fetch_sub(1, std::memory_order_release) == 1) {
+        pendingCommands.notify_all();
+    }
+}
+
+void TransactionEngine::run(Partition &partition) {
+    Command command;
+
+    while (partition.commands.consume(&command) == producer_consumer::ConsumerResult::Available) {
+        execute(partition, command);
+    }
+}
+
+// command processing for TransactionEngine, only called by the worker that owns the partition
+void TransactionEngine::execute(Partition &partition, Command &command) {
+    auto found = partition.accounts.find(command.id);
+
+    if (command.operation == Operation::Open) {
+        if (found != partition.accounts.end()) {
+            complete(command, {TransactionStatus::AccountExists, found->second.getBalance()});
+            return;
+        }
+
+        partition.accounts.emplace(command.id, Account{command.id, command.amount});
+        complete(command, {TransactionStatus::Completed, command.amount});
+        return;
+    }
+
+    if (found == partition.accounts.end()) {
+        // the target account of a transfer is unknown, so its source account gets the debited amount back
+        if (command.operation == Operation::Credit) {
+            command.operation = Operation::Refund;
+            std::swap(command.id, command.counterpartId);
+            send(std::move(command));
+            return;
+        }
+
+        complete(command, {TransactionStatus::UnknownAccount, 0.0});
+        return;
+    }
+
+    auto &account = found->second;
+
+    switch (command.operation) {
+    case Operation::Deposit:
+        account.deposit(command.amount);
+        break;
+    case Operation::Withdraw:
+        account.withdraw(command.amount);
+        break;
+    case Operation::Debit:
+        account.withdraw(command.amount);
+        command.operation = Operation::Credit;
+        command.sourceBalance = account.getBalance();
+        std::swap(command.id, command.counterpartId);
+
+        // the second phase runs on the worker of the target account, which might be this worker as well
+        if (partitionOf(command.id) == partitionOf(command.counterpartId)) {
+            execute(partition, command);
+        } else {
+            send(std::move(command));
+        }
+        return;
+    case Operation::Credit:
+        account.deposit(command.amount);
+        complete(command, {TransactionStatus::Completed, command.sourceBalance});
+        return;
+    case Operation::Refund:
+        account.deposit(command.amount);
+        complete(command, {TransactionStatus::UnknownAccount, account.getBalance()});
+        return;
+    default:
+        break;
+    }
+
+    complete(command, {TransactionStatus::Completed, account.getBalance()});
+}
+} // namespace banking
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+#include "TransactionHistory.h"
+
+namespace banking {
+// unnamed namespace for helpers with internal linkage
+namespace {
+constexpr double centsPerUnit = 100.0;
+
+// estimated bookkeeping of the allocator per heap allocation, e.g. the chunk header and alignment padding of glibc malloc
+constexpr size_t allocationOverhead = 2 * sizeof(void *);
+
+std::int64_t toMicroseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromMicroseconds(std::int64_t time) {
+    return std::chrono::system_clock::time_point{std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds{time})};
+}
+
+// append an unsigned value in 7-bit groups, the high bit of a byte marks that another byte follows
+void writeVarint(std::vector<std::uint8_t> &encoded, std::uint64_t value) {
+    for (; value >= 0x80; value >>= 7) {
+        encoded.push_back(static_cast<std::uint8_t>(value | 0x80));
+    }
+
+    encoded.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::uint64_t readVarint(const std::uint8_t *&position) {
+    std::uint64_t value = 0;
+
+    for (auto shift = 0;; shift += 7) {
+        auto byte = *position++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+}
+
+// map signed values to unsigned values, so that small negative values are encoded in few bytes as well
+std::uint64_t zigzag(std::int64_t value) { return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63); }
+std::int64_t unzigzag(std::uint64_t value) { return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1); }
+} // namespace
+
+// methods for AccountHistory
+void AccountHistory::append(std::chrono::system_clock::time_point time, double amount) {
+    auto microseconds = toMicroseconds(time);
+    auto cents = std::llround(amount * centsPerUnit);
+
+    if (!blocks.empty() && microseconds < blocks.back().lastTime) {
+        throw std::invalid_argument("account history must be appended in time order");
+    }
+
+    if (blocks.empty() || blocks.back().count == entriesPerBlock) {
+        auto balance = blocks.empty() ? 0 : blocks.back().balance;
+        blocks.push_back(BlockSummary{microseconds, microseconds, balance, static_cast<std::uint32_t>(encoded.size()), 0});
+        lastAmount = 0;
+    }
+
+    auto &block = blocks.back();
+    writeVarint(encoded, static_cast<std::uint64_t>(microseconds - block.lastTime));
+    writeVarint(encoded, zigzag(cents - lastAmount));
+    block.lastTime = microseconds;
+    block.balance += cents;
+    block.count++;
+    lastAmount = cents;
+}
+
+size_t AccountHistory::size() const { return blocks.empty() ? 0 : (blocks.size() - 1) * entriesPerBlock + blocks.back().count; }
+
+size_t AccountHistory::bytes() const {
+    auto allocations = (encoded.capacity() > 0 ? 1 : 0) + (blocks.capacity() > 0 ? 1 : 0);
+    return sizeof(AccountHistory) + encoded.capacity() + blocks.capacity() * sizeof(BlockSummary) + allocations * allocationOverhead;
+}
+
+double AccountHistory::sum(std::chrono::system_clock::time_point from, std::chrono::system_clock::time_point to) const {
+    if (to <= from) {
+        return 0.0;
+    }
+
+    return static_cast<double>(balanceBefore(toMicroseconds(to)) - balanceBefore(toMicroseconds(from))) / centsPerUnit;
+}
+
+double AccountHistory::balanceAt(std::chrono::system_clock::time_point time) const {
+    auto microseconds = toMicroseconds(time);
+
+    // all entries are at or before the latest representable time, which has no successor to search for
+    if (microseconds == std::numeric_limits<std::int64_t>::max()) {
+        return static_cast<double>(blocks.empty() ? 0 : blocks.back().balance) / centsPerUnit;
+    }
+
+    return static_cast<double>(balanceBefore(microseconds + 1)) / centsPerUnit;
+}
+
+std::vector<HistoryEntry> AccountHistory::entries(std::chrono::system_clock::time_point from, std::chrono::system_clock::time_point to) const {
+    auto first = toMicroseconds(from);
+    auto last = toMicroseconds(to);
+    auto block = std::ranges::partition_point(blocks, [first](const BlockSummary &summary) { return summary.lastTime < first; });
+    std::vector<HistoryEntry> found;
+
+    for (; block != blocks.end() && block->firstTime < last; block++) {
+        decode(*block, [first, last, &found](std::int64_t time, std::int64_t cents) {
+            if (time >= first && time < last) {
+                found.push_back(HistoryEntry{fromMicroseconds(time), static_cast<double>(cents) / centsPerUnit});
+            }
+
+            return time < last;
+        });
+    }
+
+    return found;
+}
+
+void AccountHistory::compact() {
+    encoded.shrink_to_fit();
+    blocks.shrink_to_fit();
+}
+
+// sum of all amounts before a point in time in cents, only the block that contains the point in time is decoded
+std::int64_t AccountHistory::balanceBefore(std::int64_t time) const {
+    auto block = std::ranges::partition_point(blocks, [time](const BlockSummary &summary) { return summary.lastTime < time; });
+    auto balance = block == blocks.begin() ? std::int64_t{0} : std::prev(block)->balance;
+
+    if (block != blocks.end()) {
+        decode(*block, [time, &balance](std::int64_t entryTime, std::int64_t cents) {
+            if (entryTime < time) {
+                balance += cents;
+            }
+
+            return entryTime < time;
+        });
+    }
+
+    return balance;
+}
+
+// decode the entries of a block in order until the visitor returns false
+template <typename VISIT>
+void AccountHistory::decode(const BlockSummary &block, VISIT &&visit) const {
+    auto position = encoded.data() + block.offset;
+    auto time = block.firstTime;
+    std::int64_t cents = 0;
+
+    for (std::uint32_t entry = 0; entry < block.count; entry++) {
+        time += static_cast<std::int64_t>(readVarint(position));
+        cents += unzigzag(readVarint(position));
+
+        if (!visit(time, cents)) {
+            return;
+        }
+    }
+}
+
+// methods for TransactionHistory
+void TransactionHistory::record(int id, std::chrono::system_clock::time_point time, double amount) {
+    histories[id].append(time, amount);
+    transactionCount++;
+}
+
+const AccountHistory *TransactionHistory::find(int id) const {
+    auto found = histories.find(id);
+    return found == histories.end() ? nullptr : &found->second;
+}
+
+size_t TransactionHistory::accounts() const { return histories.size(); }
+
+size_t TransactionHistory::transactions() const { return transactionCount; }
+
+size_t TransactionHistory::bytes() const {
+    // every node is a separate allocation that holds the next pointer and the key besides the history
+    constexpr auto nodeOverhead = sizeof(void *) + sizeof(decltype(histories)::value_type) - sizeof(AccountHistory) + allocationOverhead;
+    auto bytes = sizeof(TransactionHistory) + histories.bucket_count() * sizeof(void *);
+
+    for (const auto &[id, history] : histories) {
+        bytes += nodeOverhead + history.bytes();
+    }
+
+    return bytes;
+}
+
+void TransactionHistory::compact() {
+    for (auto &[id, history] : histories) {
+        history.compact();
+    }
+}
+} // namespace banking
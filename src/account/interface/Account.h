@@ -1,6 +1,11 @@
 #pragma once
 
+#include <concepts>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
 
 namespace banking {
 // public interface for account management
@@ -20,7 +25,55 @@ class ISavingsAccount {
     virtual void applyInterest() = 0;
 };
 
+// global interest index that records the rate posted for every interest period as a cumulative interest factor
+// factor(n) is the growth of one unit of money over the first n periods, so the growth between any two periods is the ratio of
+// their factors and posting interest for any number of accounts is a single O(1) operation
+// savings accounts that accrue lazily remember the period of their last update and read the factors for their interest
+// posting takes an exclusive lock, reading a factor a shared lock, because periods are posted rarely and read on every balance access
+class InterestIndex final {
+  public:
+    void post(double rate); // appends the factor for the next period
+    std::uint64_t periods() const;
+    double factor(std::uint64_t period) const;                                 // cumulative factor after 'period' periods, 1.0 for period 0
+    double growth(std::uint64_t fromPeriod, std::uint64_t toPeriod) const;     // factor(toPeriod) / factor(fromPeriod)
+
+  private:
+    mutable std::shared_mutex factorsAccess;
+    std::vector<double> factors{1.0};
+};
+
+inline void InterestIndex::post(double rate) {
+    std::unique_lock writer{factorsAccess};
+    factors.push_back(factors.back() * (1.0 + rate));
+}
+
+inline std::uint64_t InterestIndex::periods() const {
+    std::shared_lock reader{factorsAccess};
+    return factors.size() - 1;
+}
+
+inline double InterestIndex::factor(std::uint64_t period) const {
+    std::shared_lock reader{factorsAccess};
+    return factors[static_cast<size_t>(period)];
+}
+
+inline double InterestIndex::growth(std::uint64_t fromPeriod, std::uint64_t toPeriod) const {
+    std::shared_lock reader{factorsAccess};
+    return factors[static_cast<size_t>(toPeriod)] / factors[static_cast<size_t>(fromPeriod)];
+}
+
+// concept for account types that can be used in generic code without virtual dispatch
+// IAccount satisfies the concept as well, so generic code can still be instantiated with mocks
+template <typename T>
+concept AccountLike = requires(T &account, const T &constAccount, double amount) {
+    { constAccount.getId() } -> std::convertible_to<int>;
+    { constAccount.getBalance() } -> std::convertible_to<double>;
+    account.deposit(amount);
+    account.withdraw(amount);
+};
+
 // factory functions to create accounts
 std::shared_ptr<IAccount> createAccount(int id, double balance);
 std::shared_ptr<ISavingsAccount> createSavingsAccount(int id, double balance, double interestRate);
+std::shared_ptr<ISavingsAccount> createSavingsAccount(int id, double balance, double interestRate, std::shared_ptr<const InterestIndex> interestIndex);
 } // namespace banking
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ConcreteAccount.h"
+
+namespace banking {
+// on-disk header of a binary account snapshot
+// the snapshot stores account state in columns: all ids, then all balances, then all interest rates
+// every column starts at a cache-line aligned offset and has its own FNV-1a checksum
+struct SnapshotHeader {
+    static constexpr char expectedMagic[8] = {'A', 'C', 'C', 'T', 'S', 'N', 'A', 'P'};
+    static constexpr std::uint32_t currentVersion = 1;
+    static constexpr std::uint32_t nativeByteOrder = 0x01020304;
+    static constexpr std::uint64_t sortedIds = 1; // flag: ids are strictly ascending
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t count;
+    std::uint64_t flags;
+    std::uint64_t idOffset;
+    std::uint64_t balanceOffset;
+    std::uint64_t interestRateOffset;
+    std::uint64_t idChecksum;
+    std::uint64_t balanceChecksum;
+    std::uint64_t interestRateChecksum;
+};
+
+// streaming writer of a binary account snapshot
+// the number of accounts is known up front, so every column is written sequentially to its final offset through a small buffer
+// the header is written last, so an interrupted snapshot never carries a valid magic
+class AccountSnapshotWriter final {
+  public:
+    AccountSnapshotWriter(const std::string &path, std::uint64_t count); // constructor, throws std::runtime_error if the file cannot be created
+    AccountSnapshotWriter(const AccountSnapshotWriter &) = delete;
+    AccountSnapshotWriter &operator=(const AccountSnapshotWriter &) = delete;
+
+    void append(int id, double balance, double interestRate = 0.0);
+    void append(const IAccount &account, double interestRate = 0.0);
+    void finish(); // throws std::runtime_error if not exactly 'count' accounts were appended or writing failed
+
+  private:
+    static constexpr size_t bufferedAccounts = 4096;
+
+    void flush();
+
+    std::ofstream file;
+    SnapshotHeader header{};
+    std::uint64_t appended{0};
+    std::uint64_t flushed{0};
+    std::optional<int> lastId;
+    std::vector<std::int32_t> ids;
+    std::vector<double> balances;
+    std::vector<double> interestRates;
+};
+
+// read-mostly account collection that is memory-mapped from a binary account snapshot
+// loading validates the header only, so startup time is bounded by page faults on first access and not by allocation and parsing
+// the mapping is never written: an account that is modified after startup is copied into an overlay of regular accounts on first
+// modification, and all lookups by index check the overlay before the mapped columns
+// ids never change, so find only searches the mapped id column, and the column spans keep showing the state of the snapshot file
+class AccountSnapshot final {
+  public:
+    explicit AccountSnapshot(const std::string &path); // constructor, throws std::runtime_error if the snapshot is invalid
+    ~AccountSnapshot();                                // destructor unmaps the snapshot
+    AccountSnapshot(const AccountSnapshot &) = delete;
+    AccountSnapshot &operator=(const AccountSnapshot &) = delete;
+
+    size_t size() const;
+    std::span<const std::int32_t> ids() const;
+    std::span<const double> balances() const;
+    std::span<const double> interestRates() const;
+
+    std::optional<size_t> find(int id) const; // binary search if ids are sorted, linear search otherwise
+    double balance(size_t index) const;       // current balance, including modifications
+    Account account(size_t index) const;      // detached copy of the current state, use modify to change the account
+    SavingsAccount savingsAccount(size_t index, std::shared_ptr<const InterestIndex> interestIndex = nullptr) const;
+    Account &modify(size_t index); // materializes the account in the overlay, the reference stays valid for the lifetime of the snapshot
+    size_t modified() const;       // number of accounts in the overlay
+    bool verify() const;           // compares all column checksums of the mapped file, touches every page of the snapshot
+
+  private:
+    const std::byte *mapped{nullptr};
+    size_t mappedSize{0};
+    SnapshotHeader header{};
+    std::unordered_map<size_t, Account> overlay; // modified accounts by index
+};
+} // namespace banking
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "Account.h"
+
+namespace banking {
+// concrete implementation of IAccount
+// the class is final and its methods are defined inline, so calls through Account are devirtualized and inlined
+class Account final : public IAccount {
+  public:
+    Account(int id, double balance); // constructor
+    Account(double balance);         // conversion constructor
+    ~Account() override = default;   // virtual destructor
+
+    operator double() const; // conversion operator
+
+    // IAccount interface
+    int getId() const override;
+    double getBalance() const override;
+    void deposit(double amount) override;
+    void withdraw(double amount) override;
+
+  private:
+    int id;
+    double balance;
+};
+
+// concrete implementation of IAccount and ISavingsAccount
+// the savings account is composed of an account because a final class cannot be derived from
+// with an interest index the account accrues interest lazily at the rates posted to the index: reading the balance includes interest
+// for all periods posted since the last update, and deposits or withdrawals first settle that interest into the balance
+// accrued interest is rounded to cents, and reading the balance returns exactly what settling would store, so the balance only
+// depends on the posted rates and on the periods in which the balance was changed, never on when or how often it is read
+// the interest rate of the account is only used by applyInterest, which posts interest to this account alone
+class SavingsAccount final : public IAccount, public ISavingsAccount {
+  public:
+    SavingsAccount(int id, double balance, double interestRate);                                                    // eager constructor
+    SavingsAccount(int id, double balance, double interestRate, std::shared_ptr<const InterestIndex> interestIndex); // lazy constructor
+    ~SavingsAccount() override = default;                                                                           // virtual destructor
+
+    // IAccount interface
+    int getId() const override;
+    double getBalance() const override;
+    void deposit(double amount) override;
+    void withdraw(double amount) override;
+
+    // ISavingsAccount interface
+    void applyInterest() override;
+
+  private:
+    static double roundToCents(double amount);
+    double accrued(std::uint64_t periods) const;
+    void settle();
+
+    Account account;
+    double interestRate;
+    std::shared_ptr<const InterestIndex> interestIndex;
+    std::uint64_t settledPeriods;
+};
+
+// constructors and operators for Account
+inline Account::Account(double balance) : Account(0, balance) {}
+inline Account::Account(int id, double balance) : id{id}, balance{balance} {}
+inline Account::operator double() const { return balance; }
+
+// interface methods for Account
+inline int Account::getId() const { return id; }
+inline double Account::getBalance() const { return balance; }
+inline void Account::deposit(double amount) { balance += amount; }
+inline void Account::withdraw(double amount) { balance -= amount; }
+
+// constructors and interface methods for SavingsAccount
+inline SavingsAccount::SavingsAccount(int id, double balance, double interestRate) : SavingsAccount(id, balance, interestRate, nullptr) {}
+inline SavingsAccount::SavingsAccount(int id, double balance, double interestRate, std::shared_ptr<const InterestIndex> interestIndex)
+    : account{id, balance}, interestRate{interestRate}, interestIndex{std::move(interestIndex)},
+      settledPeriods{this->interestIndex ? this->interestIndex->periods() : 0} {}
+inline int SavingsAccount::getId() const { return account.getId(); }
+inline double SavingsAccount::getBalance() const { return interestIndex ? accrued(interestIndex->periods()) : account.getBalance(); }
+inline void SavingsAccount::deposit(double amount) {
+    settle();
+    account.deposit(amount);
+}
+inline void SavingsAccount::withdraw(double amount) {
+    settle();
+    account.withdraw(amount);
+}
+inline void SavingsAccount::applyInterest() {
+    settle();
+    account.deposit(account.getBalance() * interestRate);
+}
+
+// lazy interest accrual for SavingsAccount
+// the growth between two periods is the ratio of their cumulative factors, which the index computes the same way for every account
+inline double SavingsAccount::roundToCents(double amount) { return std::round(amount * 100.0) / 100.0; }
+inline double SavingsAccount::accrued(std::uint64_t periods) const {
+    if (periods == settledPeriods) {
+        return account.getBalance();
+    }
+
+    return roundToCents(account.getBalance() * interestIndex->growth(settledPeriods, periods));
+}
+inline void SavingsAccount::settle() {
+    if (!interestIndex) {
+        return;
+    }
+
+    auto periods = interestIndex->periods();
+    account = Account{account.getId(), accrued(periods)};
+    settledPeriods = periods;
+}
+} // namespace banking
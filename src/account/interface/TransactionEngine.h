@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ConcreteAccount.h"
+#include "Metrics.h"
+#include "ProducerConsumer.h"
+
+namespace banking {
+// outcome of a command that was submitted to the transaction engine
+enum class TransactionStatus { Completed, UnknownAccount, AccountExists, Stopped };
+
+// result of a command, the balance is the one of the addressed account (the source account for transfers) after the command
+struct TransactionResult {
+    TransactionStatus status;
+    double balance;
+};
+
+// transaction engine that processes account commands without locking the accounts
+// accounts are partitioned by id across worker threads, every worker exclusively owns the accounts of its partition and
+// is fed by its own producer-consumer queue, so balance updates never contend and stay in the cache of one core
+// a transfer between partitions is a two-phase message exchange: the source partition debits and sends a credit to the
+// target partition, which refunds the source partition if the target account is unknown
+// destroying the engine waits until all submitted commands completed
+// completed commands are counted per status in the process-wide metrics registry
+class TransactionEngine final {
+  public:
+    explicit TransactionEngine(size_t partitionCount = std::thread::hardware_concurrency()); // constructor, starts one worker per partition
+    ~TransactionEngine();                                                                     // destructor, completes queued commands
+    TransactionEngine(const TransactionEngine &) = delete;
+    TransactionEngine &operator=(const TransactionEngine &) = delete;
+
+    std::future<TransactionResult> open(int id, double balance);
+    std::future<TransactionResult> deposit(int id, double amount);
+    std::future<TransactionResult> withdraw(int id, double amount);
+    std::future<TransactionResult> transfer(int fromId, int toId, double amount);
+    std::future<TransactionResult> balance(int id);
+
+    size_t partitions() const;
+    size_t partitionOf(int id) const;
+
+  private:
+    enum class Operation { Open, Deposit, Withdraw, Debit, Credit, Refund, Balance };
+
+    // message that is processed by the worker of the partition that owns 'id'
+    struct Command {
+        Operation operation{Operation::Balance};
+        int id{0};
+        int counterpartId{0};
+        double amount{0.0};
+        double sourceBalance{0.0}; // balance of the source account after the debit of a transfer
+        std::promise<TransactionResult> result;
+    };
+
+    // partition state is only touched by its worker and aligned to keep neighbouring partitions off its cache lines
+    struct alignas(producer_consumer::cacheLineSize) Partition {
+        producer_consumer::ProducerConsumer<Command, int> commands;
+        std::unordered_map<int, Account> accounts;
+        std::jthread worker;
+    };
+
+    std::future<TransactionResult> submit(Operation operation, int id, int counterpartId, double amount);
+    void send(Command &&command);
+    void complete(Command &command, TransactionResult result);
+    void run(Partition &partition);
+    void execute(Partition &partition, Command &command);
+
+    std::vector<std::unique_ptr<Partition>> partitionList;
+    std::atomic<size_t> pendingCommands{0};
+    std::array<metrics::Counter *, 4> completedCommands{}; // indexed by TransactionStatus
+};
+} // namespace banking
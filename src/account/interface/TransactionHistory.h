@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace banking {
+// single deposit (positive amount) or withdrawal (negative amount) of an account
+struct HistoryEntry {
+    std::chrono::system_clock::time_point time;
+    double amount;
+};
+
+// append-only, compressed deposit and withdrawal history of one account
+// entries are grouped into blocks of a fixed number of entries, every entry is encoded as the varint of its time delta to the
+// previous entry and the zigzag varint of its amount delta to the previous amount, so a typical entry takes two to five bytes
+// every block has a summary with its time range and the running balance at its end, so range sums and balances at a point in
+// time decode at most two blocks
+// amounts are stored in cents and times in microseconds, times must not decrease
+// besides its entries, every history has a fixed cost of the object itself and of up to two heap allocations
+class AccountHistory final {
+  public:
+    void append(std::chrono::system_clock::time_point time, double amount); // throws std::invalid_argument if time is before the last entry
+
+    size_t size() const;
+    size_t bytes() const;                                                                                   // memory used by the object and its heap allocations
+    double sum(std::chrono::system_clock::time_point from, std::chrono::system_clock::time_point to) const; // sum of amounts in [from, to)
+    double balanceAt(std::chrono::system_clock::time_point time) const;                                     // sum of amounts up to and including time
+    std::vector<HistoryEntry> entries(std::chrono::system_clock::time_point from, std::chrono::system_clock::time_point to) const; // entries in [from, to)
+    void compact(); // releases spare capacity, e.g. for accounts without recent activity
+
+  private:
+    static constexpr std::uint32_t entriesPerBlock = 64;
+
+    // summary of a block, times in microseconds and balance in cents
+    struct BlockSummary {
+        std::int64_t firstTime;
+        std::int64_t lastTime;
+        std::int64_t balance; // sum of all amounts up to and including this block
+        std::uint32_t offset;
+        std::uint32_t count;
+    };
+
+    std::int64_t balanceBefore(std::int64_t time) const;
+    template <typename VISIT>
+    void decode(const BlockSummary &block, VISIT &&visit) const;
+
+    std::vector<std::uint8_t> encoded;
+    std::vector<BlockSummary> blocks;
+    std::int64_t lastAmount{0};
+};
+
+// compressed deposit and withdrawal histories of many accounts
+// every account costs a hash map node, its bucket, and the fixed cost of its history, about 170 bytes on 64-bit platforms,
+// so the compression pays off for accounts with more than a few dozen transactions
+class TransactionHistory final {
+  public:
+    void record(int id, std::chrono::system_clock::time_point time, double amount); // throws std::invalid_argument if time is before the last entry of the account
+
+    const AccountHistory *find(int id) const; // nullptr if the account has no history
+    size_t accounts() const;
+    size_t transactions() const;
+    size_t bytes() const; // memory used by the histories of all accounts including the hash map, heap allocation overhead is estimated
+    void compact();
+
+  private:
+    std::unordered_map<int, AccountHistory> histories;
+    size_t transactionCount{0};
+};
+} // namespace banking
@@ -1,6 +1,16 @@
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <future>
+#include <stdexcept>
+#include <vector>
 
 #include "AccountMock.h"
+#include "AccountSnapshot.h"
+#include "ConcreteAccount.h"
+#include "Factory.h"
+#include "TransactionEngine.h"
+#include "TransactionHistory.h"
 
 using namespace ::testing;
 using namespace banking_mock;
@@ -8,6 +18,17 @@ using namespace banking_mock;
 namespace banking {
 namespace testing {
 namespace {
+// generic function that is devirtualized for final account types and still accepts mocks
+template <AccountLike ACCOUNT>
+double settle(ACCOUNT &account, double amount, int times) {
+    for (auto count = 0; count < times; count++) {
+        account.deposit(amount);
+        account.withdraw(amount / 2);
+    }
+
+    return account.getBalance();
+}
+
 TEST(MockSuite, MockAccount) {
     // Prepare
     AccountMock account;
@@ -39,6 +60,275 @@ TEST(BankingSuite, AccountTest) {
     EXPECT_EQ(id, 1);
     EXPECT_EQ(balance, 1050.0);
 }
+
+TEST(MockSuite, MockAccountLike) {
+    // Prepare
+    AccountMock account;
+
+    EXPECT_CALL(account, deposit(100.0)).Times(Exactly(2));
+    EXPECT_CALL(account, withdraw(50.0)).Times(Exactly(2));
+    EXPECT_CALL(account, getBalance).WillOnce(Return(1100.0));
+
+    // Execute
+    auto balance = settle(account, 100.0, 2);
+
+    // Expect
+    EXPECT_EQ(balance, 1100.0);
+}
+
+TEST(BankingSuite, ConcreteAccountTest) {
+    // Prepare
+    static_assert(AccountLike<Account>);
+    static_assert(AccountLike<SavingsAccount>);
+    static_assert(AccountLike<IAccount>);
+
+    auto account = factory::CreateUniqueConcrete<IAccount, Account>(1, 1000.0);
+    auto savingsAccount = factory::CreateSharedConcrete<ISavingsAccount, SavingsAccount>(2, 1000.0, 0.05);
+
+    // Execute
+    auto balance = settle(*account, 100.0, 2);
+    savingsAccount->applyInterest();
+    auto savingsBalance = settle(*savingsAccount, 100.0, 1);
+
+    // Expect
+    EXPECT_EQ(balance, 1100.0);
+    EXPECT_EQ(savingsBalance, 1100.0);
+    EXPECT_EQ(savingsAccount->getId(), 2);
+}
+
+TEST(BankingSuite, LazyInterestTest) {
+    // Prepare
+    auto interestIndex = std::make_shared<InterestIndex>();
+    SavingsAccount lazyAccount{1, 1000.0, 0.05, interestIndex};
+    SavingsAccount readAccount{2, 1000.0, 0.05, interestIndex};
+    SavingsAccount unreadAccount{5, 1000.0, 0.05, interestIndex};
+    SavingsAccount eagerAccount{3, 1000.0, 0.05};
+
+    // Execute
+    for (auto period = 0; period < 3; period++) {
+        interestIndex->post(0.05);
+        eagerAccount.applyInterest();
+        readAccount.getBalance();
+    }
+
+    SavingsAccount lateAccount{4, 1000.0, 0.05, interestIndex};
+    auto accruedBalance = lazyAccount.getBalance();
+    lazyAccount.deposit(100.0);
+    auto settledBalance = lazyAccount.getBalance();
+    interestIndex->post(0.02);
+
+    // Expect
+    EXPECT_EQ(interestIndex->periods(), 4U);
+    EXPECT_DOUBLE_EQ(interestIndex->factor(4), 1.05 * 1.05 * 1.05 * 1.02);
+    EXPECT_DOUBLE_EQ(eagerAccount.getBalance(), 1157.625);
+    EXPECT_DOUBLE_EQ(accruedBalance, 1157.63);
+    EXPECT_DOUBLE_EQ(settledBalance, 1257.63);
+    EXPECT_DOUBLE_EQ(lazyAccount.getBalance(), 1282.78);
+    EXPECT_EQ(readAccount.getBalance(), unreadAccount.getBalance());
+    EXPECT_DOUBLE_EQ(readAccount.getBalance(), 1180.78);
+    EXPECT_DOUBLE_EQ(lateAccount.getBalance(), 1020.0);
+}
+
+TEST(BankingSuite, AccountSnapshotTest) {
+    // Prepare
+    auto path = (std::filesystem::temp_directory_path() / "cpp_playground_accounts.snapshot").string();
+    AccountSnapshotWriter writer{path, 5000};
+
+    for (auto id = 1; id <= 5000; id++) {
+        writer.append(Account{id, id * 10.0}, id % 2 == 0 ? 0.05 : 0.0);
+    }
+
+    writer.finish();
+
+    // Execute
+    auto snapshot = std::make_unique<AccountSnapshot>(path);
+    auto size = snapshot->size();
+    auto verified = snapshot->verify();
+    auto index = snapshot->find(4242);
+    auto missing = snapshot->find(5001);
+    auto account = snapshot->account(*index);
+    auto savingsAccount = snapshot->savingsAccount(*index);
+    savingsAccount.applyInterest();
+    snapshot->modify(*index).deposit(100.0);
+    snapshot->modify(*index).withdraw(20.0);
+    auto modifiedBalance = snapshot->balance(*index);
+    auto modifiedAccount = snapshot->account(*index);
+    auto modified = snapshot->modified();
+    auto mappedBalance = snapshot->balances()[*index];
+    auto unmodifiedBalance = snapshot->balance(0);
+    snapshot.reset();
+
+    {
+        std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+
+    auto corrupted = AccountSnapshot{path}.verify();
+
+    {
+        std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+        file.put('X');
+    }
+
+    // Expect
+    EXPECT_EQ(size, 5000UL);
+    EXPECT_TRUE(verified);
+    ASSERT_TRUE(index.has_value());
+    EXPECT_EQ(*index, 4241UL);
+    EXPECT_FALSE(missing.has_value());
+    EXPECT_EQ(account.getId(), 4242);
+    EXPECT_EQ(account.getBalance(), 42420.0);
+    EXPECT_DOUBLE_EQ(savingsAccount.getBalance(), 42420.0 * 1.05);
+    EXPECT_EQ(modifiedBalance, 42500.0);
+    EXPECT_EQ(modifiedAccount.getBalance(), 42500.0);
+    EXPECT_EQ(modified, 1UL);
+    EXPECT_EQ(mappedBalance, 42420.0);
+    EXPECT_EQ(unmodifiedBalance, 10.0);
+    EXPECT_FALSE(corrupted);
+    EXPECT_THROW(AccountSnapshot{path}, std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST(BankingSuite, TransactionEngineTest) {
+    // Prepare
+    TransactionEngine engine{4};
+
+    for (auto id = 1; id <= 8; id++) {
+        engine.open(id, 100.0);
+    }
+
+    auto duplicate = engine.open(1, 500.0).get();
+
+    // Execute
+    std::vector<std::future<TransactionResult>> transfers;
+
+    for (auto round = 0; round < 100; round++) {
+        for (auto id = 1; id <= 8; id++) {
+            transfers.push_back(engine.transfer(id, id % 8 + 1, 1.0 + id));
+        }
+    }
+
+    engine.open(9, 0.0);
+    auto deposit = engine.deposit(9, 50.0).get();
+    auto withdraw = engine.withdraw(9, 25.0).get();
+    auto unknownSource = engine.transfer(42, 1, 10.0).get();
+    auto unknownTarget = engine.transfer(2, 42, 10.0).get();
+    auto completed = 0;
+
+    for (auto &transfer : transfers) {
+        completed += transfer.get().status == TransactionStatus::Completed ? 1 : 0;
+    }
+
+    auto total = 0.0;
+
+    for (auto id = 1; id <= 8; id++) {
+        total += engine.balance(id).get().balance;
+    }
+
+    auto unknownBalance = engine.balance(42).get();
+
+    // Expect
+    EXPECT_EQ(engine.partitions(), 4UL);
+    EXPECT_EQ(duplicate.status, TransactionStatus::AccountExists);
+    EXPECT_EQ(duplicate.balance, 100.0);
+    EXPECT_EQ(deposit.status, TransactionStatus::Completed);
+    EXPECT_EQ(withdraw.status, TransactionStatus::Completed);
+    EXPECT_EQ(deposit.balance, 50.0);
+    EXPECT_EQ(withdraw.balance, 25.0);
+    EXPECT_EQ(unknownSource.status, TransactionStatus::UnknownAccount);
+    EXPECT_EQ(unknownTarget.status, TransactionStatus::UnknownAccount);
+    EXPECT_EQ(completed, 800);
+    EXPECT_EQ(total, 8 * 100.0);
+    EXPECT_EQ(unknownBalance.status, TransactionStatus::UnknownAccount);
+}
+
+TEST(BankingSuite, TransactionEnginePartitionTest) {
+    // Prepare
+    TransactionEngine engine{3};
+    TransactionEngine defaultEngine{0};
+    std::vector<size_t> accountsPerPartition(engine.partitions());
+
+    // Execute
+    auto inRange = true;
+
+    for (auto id = 0; id < 3000; id++) {
+        auto partition = engine.partitionOf(id);
+        inRange = inRange && partition < engine.partitions();
+
+        if (partition < accountsPerPartition.size()) {
+            accountsPerPartition[partition]++;
+        }
+    }
+
+    auto opened = engine.open(7, 10.0).get();
+    auto balance = engine.balance(7).get();
+
+    // Expect
+    EXPECT_EQ(engine.partitions(), 3UL);
+    EXPECT_EQ(defaultEngine.partitions(), 1UL);
+    EXPECT_TRUE(inRange);
+
+    for (auto accounts : accountsPerPartition) {
+        EXPECT_GT(accounts, 900UL);
+    }
+
+    EXPECT_EQ(opened.status, TransactionStatus::Completed);
+    EXPECT_EQ(balance.balance, 10.0);
+}
+
+TEST(BankingSuite, TransactionHistoryTest) {
+    // Prepare
+    TransactionHistory history;
+    auto start = std::chrono::system_clock::time_point{} + std::chrono::hours{24 * 365 * 55};
+    std::vector<HistoryEntry> reference;
+
+    for (auto index = 0; index < 1000; index++) {
+        auto time = start + std::chrono::seconds{37 * index};
+        auto amount = index % 3 == 0 ? 100.25 : -(index % 7) * 10.10;
+        history.record(1, time, amount);
+        reference.push_back(HistoryEntry{time, amount});
+    }
+
+    history.record(2, start, 5.0);
+    history.compact();
+    TransactionHistory smallHistory;
+    smallHistory.record(1, start, 5.0);
+    smallHistory.compact();
+
+    // Execute
+    auto account = history.find(1);
+    auto from = start + std::chrono::seconds{37 * 100};
+    auto to = start + std::chrono::seconds{37 * 900 + 1};
+    auto sum = account->sum(from, to);
+    auto balance = account->balanceAt(start + std::chrono::seconds{37 * 500});
+    auto entries = account->entries(from, to);
+
+    auto expectedSum = 0.0;
+    auto expectedBalance = 0.0;
+
+    for (const auto &entry : reference) {
+        expectedSum += entry.time >= from && entry.time < to ? entry.amount : 0.0;
+        expectedBalance += entry.time <= start + std::chrono::seconds{37 * 500} ? entry.amount : 0.0;
+    }
+
+    // Expect
+    EXPECT_EQ(history.accounts(), 2UL);
+    EXPECT_EQ(history.transactions(), 1001UL);
+    EXPECT_EQ(account->size(), 1000UL);
+    EXPECT_EQ(history.find(3), nullptr);
+    EXPECT_NEAR(sum, expectedSum, 1e-6);
+    EXPECT_NEAR(balance, expectedBalance, 1e-6);
+    EXPECT_NEAR(account->balanceAt(std::chrono::system_clock::time_point::max()), account->balanceAt(reference.back().time), 1e-6);
+    ASSERT_EQ(entries.size(), 801UL);
+    EXPECT_EQ(entries.front().time, from);
+    EXPECT_DOUBLE_EQ(entries.front().amount, reference[100].amount);
+    EXPECT_EQ(entries.back().time, reference[900].time);
+    EXPECT_LT(history.bytes(), history.transactions() * sizeof(HistoryEntry) / 2);
+    EXPECT_GT(smallHistory.bytes(), sizeof(AccountHistory) + sizeof(HistoryEntry));
+    EXPECT_THROW(history.record(1, start, 1.0), std::invalid_argument);
+    EXPECT_EQ(history.transactions(), 1001UL);
+}
 } // namespace
 } // namespace testing
 } // namespace banking
\ No newline at end of file
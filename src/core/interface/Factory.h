@@ -47,4 +47,30 @@ template <AbstractClass I, std::derived_from<I> T, typename... ARGS>
 auto CreateUnique(ARGS &&...args) -> std::unique_ptr<I> {
     return std::make_unique<T>(std::forward<ARGS>(args)...);
 }
+
+/// @brief Variadic function template to create a shared pointer to the concrete type T that implements interface I.
+/// @details In contrast to CreateShared the static type of the result is T. Calls through it to a final class T are devirtualized and can be inlined.
+///          The interface I only constrains T, so generic code can still be written against I for mocking.
+/// @tparam I       The interface type that the object must implement
+/// @tparam T       The concrete type of the object to create, which must derive from I
+/// @tparam ...ARGS Declares template parameter pack of types for the constructor arguments of T
+/// @param ...args  Declares function parameter pack, using forwarding references
+/// @return         A shared pointer to an object of the concrete type T
+template <AbstractClass I, std::derived_from<I> T, typename... ARGS>
+auto CreateSharedConcrete(ARGS &&...args) -> std::shared_ptr<T> {
+    return std::make_shared<T>(std::forward<ARGS>(args)...);
+}
+
+/// @brief Variadic function template to create a unique pointer to the concrete type T that implements interface I.
+/// @details In contrast to CreateUnique the static type of the result is T. Calls through it to a final class T are devirtualized and can be inlined.
+///          The interface I only constrains T, so generic code can still be written against I for mocking.
+/// @tparam I       The interface type that the object must implement
+/// @tparam T       The concrete type of the object to create, which must derive from I
+/// @tparam ...ARGS Declares template parameter pack of types for the constructor arguments of T
+/// @param ...args  Declares function parameter pack, using forwarding references
+/// @return         A unique pointer to an object of the concrete type T
+template <AbstractClass I, std::derived_from<I> T, typename... ARGS>
+auto CreateUniqueConcrete(ARGS &&...args) -> std::unique_ptr<T> {
+    return std::make_unique<T>(std::forward<ARGS>(args)...);
+}
 } // namespace factory
\ No newline at end of file
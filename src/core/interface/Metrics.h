@@ -0,0 +1,300 @@
+/// @file Metrics.h
+/// @brief This header defines a process-wide registry of counters, gauges, and histograms that is exported in the Prometheus text format.
+/// @details Counters and histograms are sharded: every thread updates its own cache-line aligned shard with relaxed atomics,
+///          so updates from different threads do not contend. Reading a metric sums up all shards, which is only done when exporting.
+///          Metrics are registered once by name and labels and live as long as the process, so components keep references to them.
+///          MetricsExporter.h provides exporters that periodically write the registry to a file or serve it on a localhost HTTP port.
+/// @date 2025
+/// @author Michael Petersen
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace metrics {
+/// @brief Number of shards of counters and histograms, threads beyond this number share shards.
+inline constexpr size_t shardCount = 16;
+
+/// @brief Cache line size used to align shards that are written by different threads.
+inline constexpr size_t shardAlignment = 64;
+
+/// @brief Retrieve the shard of the calling thread.
+/// @details Threads are assigned to shards round robin on their first update, so up to shardCount threads never share a shard.
+/// @return Index of the shard of the calling thread
+inline size_t shardIndex() {
+    static std::atomic<size_t> nextShard{0};
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % shardCount;
+    return shard;
+}
+
+/// @brief Format a number in the shortest representation that reads back to the same value.
+/// @param value Number to format
+/// @return      Text representation as expected by the Prometheus text format
+inline std::string format(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+
+    std::array<char, 32> text{};
+    auto [end, error] = std::to_chars(text.data(), text.data() + text.size(), value);
+    return std::string{text.data(), end};
+}
+
+/// @brief Monotonically increasing counter, e.g. the number of processed items.
+class Counter final {
+  public:
+    /// @brief Increase the counter.
+    /// @param amount Amount to add
+    void increment(std::uint64_t amount = 1) noexcept { shards[shardIndex()].value.fetch_add(amount, std::memory_order_relaxed); }
+
+    /// @brief Retrieve the sum of all shards.
+    /// @return Current value of the counter
+    std::uint64_t value() const noexcept {
+        std::uint64_t sum = 0;
+
+        for (const auto &shard : shards) {
+            sum += shard.value.load(std::memory_order_relaxed);
+        }
+
+        return sum;
+    }
+
+  private:
+    struct alignas(shardAlignment) Shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::array<Shard, shardCount> shards{};
+};
+
+/// @brief Value that can go up and down, e.g. the number of queued items.
+/// @details A gauge is set rather than accumulated, so it is a single atomic and not sharded.
+class Gauge final {
+  public:
+    /// @brief Set the gauge to a value.
+    /// @param value New value
+    void set(double value) noexcept { current.store(value, std::memory_order_relaxed); }
+
+    /// @brief Add an amount to the gauge.
+    /// @param amount Amount to add, negative to subtract
+    void add(double amount) noexcept { current.fetch_add(amount, std::memory_order_relaxed); }
+
+    /// @brief Retrieve the value of the gauge.
+    /// @return Current value of the gauge
+    double value() const noexcept { return current.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<double> current{0.0};
+};
+
+/// @brief Distribution of observed values in buckets with fixed upper bounds, e.g. latencies.
+class Histogram final {
+  public:
+    /// @brief Construct a histogram with fixed bucket bounds.
+    /// @param bounds Inclusive upper bounds of the buckets, an additional bucket collects all larger values
+    explicit Histogram(std::vector<double> bounds) : bounds{std::move(bounds)} {
+        std::ranges::sort(this->bounds);
+
+        for (auto &shard : shards) {
+            shard.buckets = std::make_unique<std::atomic<std::uint64_t>[]>(this->bounds.size() + 1);
+        }
+    }
+
+    /// @brief Record an observed value.
+    /// @param value Observed value
+    void observe(double value) noexcept {
+        auto bucket = static_cast<size_t>(std::ranges::lower_bound(bounds, value) - bounds.begin());
+        auto &shard = shards[shardIndex()];
+        shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /// @brief Retrieve the inclusive upper bounds of the buckets.
+    /// @return Sorted bucket bounds without the final unbounded bucket
+    const std::vector<double> &upperBounds() const noexcept { return bounds; }
+
+    /// @brief Retrieve the number of observed values per bucket, summed up over all shards.
+    /// @return Non-cumulative counts, the last element counts values above all bounds
+    std::vector<std::uint64_t> counts() const {
+        std::vector<std::uint64_t> counts(bounds.size() + 1, 0);
+
+        for (const auto &shard : shards) {
+            for (size_t bucket = 0; bucket < counts.size(); bucket++) {
+                counts[bucket] += shard.buckets[bucket].load(std::memory_order_relaxed);
+            }
+        }
+
+        return counts;
+    }
+
+    /// @brief Retrieve the sum of all observed values.
+    /// @return Sum of observed values
+    double sum() const noexcept {
+        auto sum = 0.0;
+
+        for (const auto &shard : shards) {
+            sum += shard.sum.load(std::memory_order_relaxed);
+        }
+
+        return sum;
+    }
+
+  private:
+    struct alignas(shardAlignment) Shard {
+        std::unique_ptr<std::atomic<std::uint64_t>[]> buckets;
+        std::atomic<double> sum{0.0};
+    };
+
+    std::vector<double> bounds;
+    std::array<Shard, shardCount> shards{};
+};
+
+/// @brief Process-wide registry of all metrics.
+/// @details Metrics are identified by their name and their labels, e.g. name "queue_items" and labels "queue=\"orders\"".
+///          Registering an existing metric again returns the existing instance, so independent components can share a metric.
+class Registry final {
+  public:
+    /// @brief Retrieve the process-wide registry.
+    /// @return Registry instance
+    static Registry &instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    /// @brief Register a counter or retrieve an existing one.
+    /// @param name   Metric name, should end with _total
+    /// @param help   Description of the metric
+    /// @param labels Comma-separated label pairs without braces, empty for none
+    /// @return       Counter that lives as long as the process
+    Counter &counter(const std::string &name, const std::string &help, const std::string &labels = "") {
+        return std::get<Counter>(series(name, help, "counter", labels, [] { return std::make_unique<Metric>(std::in_place_type<Counter>); }));
+    }
+
+    /// @brief Register a gauge or retrieve an existing one.
+    /// @param name   Metric name
+    /// @param help   Description of the metric
+    /// @param labels Comma-separated label pairs without braces, empty for none
+    /// @return       Gauge that lives as long as the process
+    Gauge &gauge(const std::string &name, const std::string &help, const std::string &labels = "") {
+        return std::get<Gauge>(series(name, help, "gauge", labels, [] { return std::make_unique<Metric>(std::in_place_type<Gauge>); }));
+    }
+
+    /// @brief Register a histogram or retrieve an existing one.
+    /// @param name   Metric name
+    /// @param help   Description of the metric
+    /// @param bounds Inclusive upper bounds of the buckets, ignored if the histogram exists
+    /// @param labels Comma-separated label pairs without braces, empty for none
+    /// @return       Histogram that lives as long as the process
+    Histogram &histogram(const std::string &name, const std::string &help, const std::vector<double> &bounds, const std::string &labels = "") {
+        return std::get<Histogram>(
+            series(name, help, "histogram", labels, [&bounds] { return std::make_unique<Metric>(std::in_place_type<Histogram>, bounds); }));
+    }
+
+    /// @brief Render all metrics in the Prometheus text exposition format.
+    /// @return Text with one HELP and TYPE comment per metric name followed by its samples
+    std::string exposition() const {
+        std::string text;
+        std::unique_lock reader{familiesAccess};
+
+        for (const auto &[name, family] : families) {
+            text += "# HELP " + name + " " + family.help + "\n# TYPE " + name + " " + family.type + "\n";
+
+            for (const auto &[labels, metric] : family.series) {
+                if (auto counter = std::get_if<Counter>(metric.get())) {
+                    text += name + braces(labels) + " " + std::to_string(counter->value()) + "\n";
+                } else if (auto gauge = std::get_if<Gauge>(metric.get())) {
+                    text += name + braces(labels) + " " + format(gauge->value()) + "\n";
+                } else if (auto histogram = std::get_if<Histogram>(metric.get())) {
+                    auto counts = histogram->counts();
+                    auto separator = labels.empty() ? "" : ",";
+                    std::uint64_t cumulative = 0;
+
+                    for (size_t bucket = 0; bucket < counts.size(); bucket++) {
+                        auto bound = bucket < histogram->upperBounds().size() ? format(histogram->upperBounds()[bucket]) : "+Inf";
+                        cumulative += counts[bucket];
+                        text += name + "_bucket{" + labels + separator + "le=\"" + bound + "\"} " + std::to_string(cumulative) + "\n";
+                    }
+
+                    text += name + "_sum" + braces(labels) + " " + format(histogram->sum()) + "\n";
+                    text += name + "_count" + braces(labels) + " " + std::to_string(cumulative) + "\n";
+                }
+            }
+        }
+
+        return text;
+    }
+
+    /// @brief Write all metrics in the Prometheus text exposition format to a file.
+    /// @details The text is written to a temporary file that replaces the file, so readers never see a partially written file.
+    /// @param path Path of the file to write
+    /// @return     The file was written successfully
+    bool dump(const std::string &path) const {
+        auto temporary = path + ".tmp";
+
+        {
+            std::ofstream file{temporary, std::ios::out | std::ios::trunc};
+            file << exposition();
+
+            if (!file) {
+                return false;
+            }
+        }
+
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+
+  private:
+    using Metric = std::variant<Counter, Gauge, Histogram>;
+
+    /// @brief All series of one metric name, which share the description and the type.
+    struct Family {
+        std::string help;
+        std::string type;
+        std::map<std::string, std::unique_ptr<Metric>> series;
+    };
+
+    Registry() = default;
+
+    static std::string braces(const std::string &labels) { return labels.empty() ? "" : "{" + labels + "}"; }
+
+    template <typename CREATE>
+    Metric &series(const std::string &name, const std::string &help, const char *type, const std::string &labels, CREATE create) {
+        std::unique_lock writer{familiesAccess};
+        auto &family = families.try_emplace(name, Family{help, type, {}}).first->second;
+
+        if (family.type != type) {
+            throw std::invalid_argument("metric " + name + " is already registered as " + family.type);
+        }
+
+        auto &metric = family.series[labels];
+
+        if (!metric) {
+            metric = create();
+        }
+
+        return *metric;
+    }
+
+    mutable std::mutex familiesAccess;
+    std::map<std::string, Family> families;
+};
+} // namespace metrics
@@ -0,0 +1,224 @@
+/// @file MetricsExporter.h
+/// @brief This header defines exporters that publish the metrics registry in the Prometheus text format.
+/// @details The file exporter periodically rewrites a file, e.g. for the textfile collector of the Prometheus node exporter.
+///          The HTTP exporter serves the registry on a localhost port, so Prometheus can scrape the process directly.
+///          Both exporters render the registry on a background thread, the instrumented code only pays for its relaxed atomic updates.
+/// @date 2025
+/// @author Michael Petersen
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "Metrics.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace metrics {
+/// @brief Exporter that periodically writes the registry to a file until it is destroyed.
+class FileExporter final {
+  public:
+    /// @brief Start writing the registry to a file.
+    /// @param registry Registry to export
+    /// @param path     Path of the file to write
+    /// @param interval Duration between two writes
+    FileExporter(const Registry &registry, std::string path, std::chrono::milliseconds interval)
+        : worker{[&registry, path = std::move(path), interval](std::stop_token stopToken) {
+              std::mutex intervalAccess;
+              std::condition_variable_any intervalCondition;
+              std::unique_lock lock{intervalAccess};
+
+              // the condition variable is only woken by a stop request, so each wait lasts the full interval otherwise
+              do {
+                  registry.dump(path);
+              } while (!intervalCondition.wait_for(lock, stopToken, interval, [&stopToken] { return stopToken.stop_requested(); }));
+
+              // the final state is written as well, so short-lived processes still leave their metrics behind
+              registry.dump(path);
+          }} {}
+
+  private:
+    std::jthread worker;
+};
+
+/// @brief Exporter that serves the registry over HTTP on a localhost port until it is destroyed.
+/// @details Every request is answered with the current registry, regardless of its path. Requests are served one at a time,
+///          a client that does not send its request or read the response within the connection timeout is disconnected.
+class HttpExporter final {
+  public:
+    /// @brief Start serving the registry.
+    /// @details Throws std::runtime_error if the socket library cannot be initialized or the port cannot be bound.
+    /// @param registry Registry to export
+    /// @param port     Port on the loopback interface, zero to let the operating system choose one
+    HttpExporter(const Registry &registry, std::uint16_t port) : listener{open(port)}, boundPort{localPort(listener)} {
+        worker = std::jthread{[&registry, this](std::stop_token stopToken) { serve(registry, stopToken); }};
+    }
+
+    ~HttpExporter() {
+        worker.request_stop();
+        worker.join();
+        close(listener);
+    }
+
+    HttpExporter(const HttpExporter &) = delete;
+    HttpExporter &operator=(const HttpExporter &) = delete;
+
+    /// @brief Retrieve the port the exporter listens on.
+    /// @return Bound port, which differs from the requested port if that was zero
+    std::uint16_t port() const { return boundPort; }
+
+  private:
+#if defined(_WIN32)
+    using Socket = SOCKET;
+    static constexpr Socket invalidSocket = INVALID_SOCKET;
+#else
+    using Socket = int;
+    static constexpr Socket invalidSocket = -1;
+#endif
+
+    /// @brief Initialization of the socket library for the lifetime of the exporter, only needed on Windows.
+    struct SocketLibrary {
+#if defined(_WIN32)
+        SocketLibrary() {
+            WSADATA data{};
+
+            if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+                throw std::runtime_error("cannot initialize the socket library");
+            }
+        }
+
+        ~SocketLibrary() { WSACleanup(); }
+
+        SocketLibrary(const SocketLibrary &) = delete;
+        SocketLibrary &operator=(const SocketLibrary &) = delete;
+#endif
+    };
+
+    static constexpr int pollMilliseconds = 100;
+    static constexpr std::chrono::seconds connectionTimeout{5};
+#if defined(MSG_NOSIGNAL)
+    static constexpr int sendFlags = MSG_NOSIGNAL; // a scraper that disconnects early must not raise SIGPIPE
+#else
+    static constexpr int sendFlags = 0;
+#endif
+
+    static void close(Socket socket) {
+#if defined(_WIN32)
+        closesocket(socket);
+#else
+        ::close(socket);
+#endif
+    }
+
+    static Socket open(std::uint16_t port) {
+        auto socket = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int reuse = 1;
+        setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+
+        if (socket == invalidSocket || bind(socket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || listen(socket, SOMAXCONN) != 0) {
+            if (socket != invalidSocket) {
+                close(socket);
+            }
+
+            throw std::runtime_error("cannot serve metrics on port " + std::to_string(port));
+        }
+
+        return socket;
+    }
+
+    static std::uint16_t localPort(Socket socket) {
+        sockaddr_in address{};
+        socklen_t length = sizeof(address);
+        getsockname(socket, reinterpret_cast<sockaddr *>(&address), &length);
+        return ntohs(address.sin_port);
+    }
+
+    // poll with a timeout, so a stop request is noticed while no socket is ready
+    static bool ready(Socket socket, short events) {
+        pollfd request{socket, events, 0};
+#if defined(_WIN32)
+        return WSAPoll(&request, 1, pollMilliseconds) > 0;
+#else
+        return poll(&request, 1, pollMilliseconds) > 0;
+#endif
+    }
+
+    // wait until a connection is ready, so a silent client can neither block the exporter nor its destruction
+    static bool readyBefore(Socket connection, short events, std::chrono::steady_clock::time_point deadline, const std::stop_token &stopToken) {
+        while (!stopToken.stop_requested() && std::chrono::steady_clock::now() < deadline) {
+            if (ready(connection, events)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void serve(const Registry &registry, const std::stop_token &stopToken) const {
+        while (!stopToken.stop_requested()) {
+            if (!ready(listener, POLLIN)) {
+                continue;
+            }
+
+            auto connection = accept(listener, nullptr, nullptr);
+
+            if (connection == invalidSocket) {
+                continue;
+            }
+
+            respond(registry, connection, std::chrono::steady_clock::now() + connectionTimeout, stopToken);
+            close(connection);
+        }
+    }
+
+    static void respond(const Registry &registry, Socket connection, std::chrono::steady_clock::time_point deadline, const std::stop_token &stopToken) {
+        // the request is read but not parsed, every request is a scrape
+        char buffer[4096];
+
+        if (!readyBefore(connection, POLLIN, deadline, stopToken) || recv(connection, buffer, sizeof(buffer), 0) <= 0) {
+            return;
+        }
+
+        auto body = registry.exposition();
+        auto response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " + std::to_string(body.size()) +
+                        "\r\nConnection: close\r\n\r\n" + body;
+
+        for (size_t sent = 0; sent < response.size() && readyBefore(connection, POLLOUT, deadline, stopToken);) {
+            auto written = send(connection, response.data() + sent, static_cast<int>(response.size() - sent), sendFlags);
+
+            if (written <= 0) {
+                break;
+            }
+
+            sent += static_cast<size_t>(written);
+        }
+    }
+
+    SocketLibrary library; // initialized before and cleaned up after the listener
+    Socket listener;
+    std::uint16_t boundPort;
+    std::jthread worker;
+};
+} // namespace metrics
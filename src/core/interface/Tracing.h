@@ -0,0 +1,304 @@
+/// @file Tracing.h
+/// @brief This header defines an opt-in tracing system that records timestamped events and exports them as Chrome trace-event JSON.
+/// @details Every thread records into its own fixed-size ring buffer, so recording an event takes no lock and does not allocate.
+///          The oldest events of a thread are overwritten when its ring buffer is full. The buffer of a terminated thread is reused
+///          by a new thread once its events were exported, so threads that come and go do not grow the memory without bound.
+///          The exported file can be loaded into Perfetto (ui.perfetto.dev) or chrome://tracing.
+///          Instrumented code uses the TRACE_EVENT macro, which compiles to nothing unless TRACING_ENABLED is defined.
+///          The CMake option ENABLE_TRACING defines TRACING_ENABLED for all targets that link the core library.
+/// @date 2025
+/// @author Michael Petersen
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(TRACING_ENABLED)
+#define TRACE_EVENT(name, phase, object) ::tracing::record((name), (phase), (object))
+#else
+#define TRACE_EVENT(name, phase, object) ((void)0)
+#endif
+
+namespace tracing {
+/// @brief Phases of trace events as defined by the Chrome trace-event format.
+/// @details Begin and End mark a duration on the recording thread and must be nested, Instant marks a single point in time.
+enum class Phase : char { Begin = 'B', End = 'E', Instant = 'i' };
+
+/// @brief Trace event as it is stored in the ring buffer of a thread.
+/// @details The name must be a string literal or outlive the export, the object identifies the instance that recorded the event.
+struct Event {
+    const char *name{nullptr};
+    const void *object{nullptr};
+    std::int64_t timestamp{0};
+    Phase phase{Phase::Instant};
+};
+
+/// @brief Ring buffer of trace events that is written by exactly one thread.
+/// @details The buffer is a sequence lock: the number of written events is the sequence, the writer publishes it with release semantics and
+///          separates it from the next slot write by a release fence, readers copy the slots and discard all events whose slots might have been
+///          overwritten while copying. The fields of a slot are relaxed atomics, so a reader that races with the writer reads a torn event
+///          that is discarded, but never causes a data race.
+class TraceBuffer final {
+  public:
+    static constexpr size_t capacity = size_t{1} << 14;
+
+    explicit TraceBuffer(std::uint64_t threadId) : threadId{threadId} {}
+    TraceBuffer(const TraceBuffer &) = delete;
+    TraceBuffer &operator=(const TraceBuffer &) = delete;
+
+    /// @brief Record an event, overwriting the oldest event if the buffer is full.
+    /// @param event Event to record
+    void record(const Event &event) noexcept {
+        auto position = written.load(std::memory_order_relaxed);
+        auto &slot = slots[position & (capacity - 1)];
+
+        // a reader that sees any part of this slot write also sees the sequence that marks the overwritten event as invalid
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.object.store(event.object, std::memory_order_relaxed);
+        slot.timestamp.store(event.timestamp, std::memory_order_relaxed);
+        slot.phase.store(event.phase, std::memory_order_relaxed);
+        written.store(position + 1, std::memory_order_release);
+    }
+
+    /// @brief Copy all events that are still stored in the buffer, oldest first.
+    /// @return Events of the buffer
+    std::vector<Event> snapshot() const {
+        auto end = written.load(std::memory_order_acquire);
+        auto begin = end > capacity ? end - capacity : 0;
+        std::vector<Event> copy;
+        copy.reserve(end - begin);
+
+        for (auto position = begin; position < end; position++) {
+            const auto &slot = slots[position & (capacity - 1)];
+            copy.push_back(Event{slot.name.load(std::memory_order_relaxed), slot.object.load(std::memory_order_relaxed),
+                                 slot.timestamp.load(std::memory_order_relaxed), slot.phase.load(std::memory_order_relaxed)});
+        }
+
+        // events that the writer overwrote while copying are no longer consistent, including the event the writer might be storing right now,
+        // the fence pairs with the release fence of the writer, so the second load sees every sequence whose slot write was copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto overwritten = written.load(std::memory_order_relaxed) + 1;
+        auto valid = overwritten > capacity ? overwritten - capacity : 0;
+        copy.erase(copy.begin(), copy.begin() + static_cast<std::ptrdiff_t>(std::min(end, std::max(valid, begin)) - begin));
+        return copy;
+    }
+
+    /// @brief Discard all recorded events.
+    void clear() noexcept { written.store(0, std::memory_order_release); }
+
+    /// @brief Identifier of the thread that records into this buffer, changes when the buffer is reused by another thread.
+    std::uint64_t threadId;
+
+  private:
+    friend class TraceRegistry;
+
+    /// @brief Storage of one event, the fields are atomics so that readers can copy them while the writer overwrites them.
+    struct Slot {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<const void *> object{nullptr};
+        std::atomic<std::int64_t> timestamp{0};
+        std::atomic<Phase> phase{Phase::Instant};
+    };
+
+    std::array<Slot, capacity> slots{};
+    std::atomic<std::uint64_t> written{0};
+    bool retired{false}; // the recording thread terminated, guarded by the registry
+};
+
+/// @brief Process-wide registry of the ring buffers of all threads that recorded events.
+/// @details Buffers are owned by the registry, so events of terminated threads are still exported. Once they were exported or cleared,
+///          the buffers of terminated threads are kept in a free list and handed to the next thread that records its first event.
+class TraceRegistry final {
+  public:
+    /// @brief Retrieve the process-wide registry.
+    /// @return Registry instance
+    static TraceRegistry &instance() {
+        static TraceRegistry registry;
+        return registry;
+    }
+
+    /// @brief Retrieve the ring buffer of the calling thread, creating it on first use.
+    /// @details Recording must not throw inside instrumented code, so a buffer that cannot be created is reported as null and created on a later call.
+    /// @return Ring buffer of the calling thread or null if it cannot be created
+    TraceBuffer *local() noexcept {
+        thread_local LocalBuffer owner;
+
+        if (owner.buffer == nullptr) {
+            try {
+                owner.buffer = acquire();
+            } catch (const std::exception &) {
+                return nullptr;
+            }
+        }
+
+        return owner.buffer;
+    }
+
+    /// @brief Retrieve the number of ring buffers, including the ones in the free list.
+    /// @return Number of allocated ring buffers
+    size_t allocated() const {
+        std::unique_lock reader{buffersAccess};
+        return buffers.size() + freeBuffers.size();
+    }
+
+    /// @brief Retrieve the nanoseconds since the registry was created.
+    /// @return Timestamp of the current point in time
+    std::int64_t now() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count(); }
+
+    /// @brief Write all recorded events as Chrome trace-event JSON to a file.
+    /// @details The buffers of terminated threads are moved to the free list afterwards, so their events are only exported once.
+    /// @param path Path of the file to write
+    /// @return The file was written successfully
+    bool dump(const std::string &path) {
+        std::ofstream file{path, std::ios::out | std::ios::trunc};
+        file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        std::unique_lock writer{buffersAccess};
+        auto separator = "\n";
+
+        for (const auto &buffer : buffers) {
+            for (const auto &event : buffer->snapshot()) {
+                file << separator << "{\"name\":\"" << escape(event.name) << "\",\"cat\":\"worker\",\"ph\":\"" << static_cast<char>(event.phase)
+                     << "\",\"ts\":" << event.timestamp / 1000 << '.' << std::to_string(1000 + event.timestamp % 1000).substr(1)
+                     << ",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"object\":\"" << event.object << "\"}"
+                     << (event.phase == Phase::Instant ? ",\"s\":\"t\"}" : "}");
+                separator = ",\n";
+            }
+        }
+
+        file << "\n]}\n";
+        recycleRetired();
+        return static_cast<bool>(file);
+    }
+
+    /// @brief Discard the recorded events of all threads.
+    /// @details Threads should not record events while the buffers are cleared.
+    void clear() {
+        std::unique_lock writer{buffersAccess};
+
+        for (auto &buffer : buffers) {
+            buffer->clear();
+        }
+
+        recycleRetired();
+    }
+
+  private:
+    /// @brief Owner of the ring buffer of a thread, which retires the buffer when the thread terminates.
+    struct LocalBuffer {
+        LocalBuffer() = default;
+        LocalBuffer(const LocalBuffer &) = delete;
+        LocalBuffer &operator=(const LocalBuffer &) = delete;
+
+        ~LocalBuffer() {
+            if (buffer != nullptr) {
+                TraceRegistry::instance().retire(buffer);
+            }
+        }
+
+        TraceBuffer *buffer{nullptr};
+    };
+
+    TraceRegistry() = default;
+
+    TraceBuffer *acquire() {
+        std::unique_lock writer{buffersAccess};
+        auto threadId = ++threadCount;
+
+        if (freeBuffers.empty()) {
+            return buffers.emplace_back(std::make_unique<TraceBuffer>(threadId)).get();
+        }
+
+        auto &buffer = buffers.emplace_back(std::move(freeBuffers.back()));
+        freeBuffers.pop_back();
+        buffer->clear();
+        buffer->threadId = threadId;
+        buffer->retired = false;
+        return buffer.get();
+    }
+
+    void retire(TraceBuffer *buffer) {
+        std::unique_lock writer{buffersAccess};
+        buffer->retired = true;
+    }
+
+    // must be called while holding the lock, the events of retired buffers were exported or discarded
+    void recycleRetired() {
+        auto retired = std::ranges::partition(buffers, [](const auto &buffer) { return !buffer->retired; });
+        std::ranges::move(retired, std::back_inserter(freeBuffers));
+        buffers.erase(retired.begin(), retired.end());
+    }
+
+    static std::string escape(const char *text) {
+        std::string escaped;
+
+        for (; text != nullptr && *text != '\0'; text++) {
+            if (*text == '"' || *text == '\\') {
+                escaped.push_back('\\');
+            }
+
+            escaped.push_back(*text);
+        }
+
+        return escaped;
+    }
+
+    const std::chrono::steady_clock::time_point origin{std::chrono::steady_clock::now()};
+    mutable std::mutex buffersAccess;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers; // buffers of running threads and of terminated threads that were not exported yet
+    std::vector<std::unique_ptr<TraceBuffer>> freeBuffers;
+    std::uint64_t threadCount{0};
+};
+
+/// @brief Record a trace event into the ring buffer of the calling thread.
+/// @details The event is dropped if the ring buffer of the calling thread cannot be created.
+/// @param name   Name of the event, must be a string literal
+/// @param phase  Phase of the event
+/// @param object Instance that records the event
+inline void record(const char *name, Phase phase, const void *object) noexcept {
+    auto &registry = TraceRegistry::instance();
+
+    if (auto buffer = registry.local(); buffer != nullptr) {
+        buffer->record(Event{name, object, registry.now(), phase});
+    }
+}
+
+/// @brief Write all recorded events as Chrome trace-event JSON to a file.
+/// @param path Path of the file to write
+/// @return The file was written successfully
+inline bool dump(const std::string &path) { return TraceRegistry::instance().dump(path); }
+
+/// @brief Acquire an exclusive lock on a mutex and, with tracing enabled, record the time spent waiting if the mutex was contended.
+/// @tparam MUTEX  Typename of a lockable mutex
+/// @param mutex   Mutex to lock
+/// @param object  Instance that owns the mutex
+/// @return        Exclusive lock on the mutex
+template <typename MUTEX>
+inline std::unique_lock<MUTEX> lockExclusive(MUTEX &mutex, [[maybe_unused]] const void *object) {
+#if defined(TRACING_ENABLED)
+    std::unique_lock writer{mutex, std::try_to_lock};
+
+    if (!writer.owns_lock()) {
+        record("lock contended", Phase::Begin, object);
+        writer.lock();
+        record("lock contended", Phase::End, object);
+    }
+
+    return writer;
+#else
+    return std::unique_lock{mutex};
+#endif
+}
+} // namespace tracing
@@ -0,0 +1,264 @@
+/// @file CoreTest.cpp
+/// @brief Unit tests for the core library using Google Test.
+/// @date 2025
+/// @author Michael Petersen
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Metrics.h"
+#include "MetricsExporter.h"
+#include "Tracing.h"
+
+using namespace ::testing;
+
+namespace core {
+namespace testing {
+namespace {
+/// @brief Unit test for recording trace events on two threads and exporting them as Chrome trace-event JSON.
+TEST(CoreSuite, TracingTest) {
+    // Prepare
+    auto path = (std::filesystem::temp_directory_path() / "cpp_playground_trace.json").string();
+    int object = 0;
+    tracing::TraceRegistry::instance().clear();
+
+    // Execute
+    tracing::record("consume wait", tracing::Phase::Begin, &object);
+    std::thread{[&object] { tracing::record("produce", tracing::Phase::Instant, &object); }}.join();
+    tracing::record("consume wait", tracing::Phase::End, &object);
+
+    auto dumped = tracing::dump(path);
+    std::ifstream file{path};
+    std::string json{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    std::filesystem::remove(path);
+
+    // Expect
+    EXPECT_TRUE(dumped);
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0UL);
+    EXPECT_NE(json.find("\"name\":\"consume wait\",\"cat\":\"worker\",\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"consume wait\",\"cat\":\"worker\",\"ph\":\"E\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"produce\",\"cat\":\"worker\",\"ph\":\"i\""), std::string::npos);
+}
+
+/// @brief Unit test for a trace buffer that overwrites its oldest events when it is full.
+TEST(CoreSuite, TraceBufferTest) {
+    // Prepare
+    auto buffer = std::make_unique<tracing::TraceBuffer>(1);
+
+    // Execute
+    for (size_t index = 0; index < tracing::TraceBuffer::capacity + 2; index++) {
+        buffer->record(tracing::Event{"event", nullptr, static_cast<std::int64_t>(index), tracing::Phase::Instant});
+    }
+
+    auto events = buffer->snapshot();
+
+    // Expect
+    ASSERT_FALSE(events.empty());
+    EXPECT_LT(events.size(), tracing::TraceBuffer::capacity);
+    EXPECT_EQ(events.back().timestamp, static_cast<std::int64_t>(tracing::TraceBuffer::capacity + 1));
+}
+
+/// @brief Unit test for copying a trace buffer while its thread keeps overwriting the events.
+TEST(CoreSuite, TraceBufferConcurrencyTest) {
+    // Prepare
+    auto buffer = std::make_unique<tracing::TraceBuffer>(1);
+    constexpr std::int64_t eventCount = 1'000'000;
+
+    // Execute
+    std::thread writer{[&buffer] {
+        for (std::int64_t index = 0; index < eventCount; index++) {
+            buffer->record(tracing::Event{"event", &buffer, index, tracing::Phase::Instant});
+        }
+    }};
+
+    // every copied event must be consistent, so the timestamps of a snapshot are consecutive and all objects are set
+    auto consistent = true;
+
+    for (auto snapshots = 0; snapshots < 200; snapshots++) {
+        auto events = buffer->snapshot();
+
+        for (size_t index = 0; index < events.size(); index++) {
+            consistent = consistent && events[index].object == &buffer && (index == 0 || events[index].timestamp == events[index - 1].timestamp + 1);
+        }
+    }
+
+    writer.join();
+
+    // Expect
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(buffer->snapshot().back().timestamp, eventCount - 1);
+}
+
+/// @brief Unit test for reusing the trace buffers of terminated threads once their events were exported.
+TEST(CoreSuite, TraceRegistryTest) {
+    // Prepare
+    auto path = (std::filesystem::temp_directory_path() / "cpp_playground_trace_registry.json").string();
+    auto &registry = tracing::TraceRegistry::instance();
+    int object = 0;
+    std::thread{[&object] { tracing::record("warm up", tracing::Phase::Instant, &object); }}.join();
+    registry.clear();
+    auto allocatedBefore = registry.allocated();
+
+    // Execute
+    std::vector<std::string> jsons;
+
+    for (auto index = 0; index < 3; index++) {
+        std::thread{[&object] { tracing::record("terminated", tracing::Phase::Instant, &object); }}.join();
+        registry.dump(path);
+        std::ifstream file{path};
+        jsons.emplace_back(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    }
+
+    registry.dump(path);
+    std::ifstream file{path};
+    std::string json{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    file.close();
+    std::filesystem::remove(path);
+
+    // Expect
+    EXPECT_EQ(registry.allocated(), allocatedBefore);
+
+    for (const auto &dumped : jsons) {
+        EXPECT_NE(dumped.find("\"name\":\"terminated\""), std::string::npos);
+    }
+
+    EXPECT_EQ(json.find("\"name\":\"terminated\""), std::string::npos);
+}
+
+/// @brief Unit test for sharded metrics that are updated from several threads and rendered in the Prometheus text format.
+TEST(CoreSuite, MetricsTest) {
+    // Prepare
+    auto &registry = metrics::Registry::instance();
+    auto &counter = registry.counter("core_test_events_total", "Events counted by the unit test", "source=\"threads\"");
+    auto &gauge = registry.gauge("core_test_level", "Level set by the unit test");
+    auto &histogram = registry.histogram("core_test_latency_seconds", "Latencies observed by the unit test", {0.5, 0.1});
+    auto countBefore = counter.value();
+    auto bucketsBefore = histogram.counts();
+
+    // Execute
+    std::vector<std::thread> threads;
+
+    for (auto thread = 0; thread < 4; thread++) {
+        threads.emplace_back([&counter, &histogram] {
+            for (auto index = 0; index < 1000; index++) {
+                counter.increment();
+            }
+
+            histogram.observe(0.05);
+            histogram.observe(0.2);
+            histogram.observe(1.0);
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    gauge.set(2.5);
+    gauge.add(-1.0);
+    auto &sameCounter = registry.counter("core_test_events_total", "Events counted by the unit test", "source=\"threads\"");
+    auto buckets = histogram.counts();
+    auto text = registry.exposition();
+
+    // Expect
+    EXPECT_EQ(&sameCounter, &counter);
+    EXPECT_EQ(counter.value() - countBefore, 4000UL);
+    EXPECT_EQ(histogram.upperBounds(), (std::vector<double>{0.1, 0.5}));
+    EXPECT_EQ(buckets[0] - bucketsBefore[0], 4UL);
+    EXPECT_EQ(buckets[1] - bucketsBefore[1], 4UL);
+    EXPECT_EQ(buckets[2] - bucketsBefore[2], 4UL);
+    EXPECT_THROW(registry.gauge("core_test_events_total", "Events counted by the unit test"), std::invalid_argument);
+    EXPECT_NE(text.find("# TYPE core_test_events_total counter\ncore_test_events_total{source=\"threads\"} " + std::to_string(counter.value()) + "\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("core_test_level 1.5\n"), std::string::npos);
+    EXPECT_NE(text.find("core_test_latency_seconds_bucket{le=\"0.1\"} " + std::to_string(buckets[0]) + "\n"), std::string::npos);
+    EXPECT_NE(text.find("core_test_latency_seconds_bucket{le=\"0.5\"} " + std::to_string(buckets[0] + buckets[1]) + "\n"), std::string::npos);
+    EXPECT_NE(text.find("core_test_latency_seconds_bucket{le=\"+Inf\"} " + std::to_string(buckets[0] + buckets[1] + buckets[2]) + "\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("core_test_latency_seconds_count " + std::to_string(buckets[0] + buckets[1] + buckets[2]) + "\n"), std::string::npos);
+}
+
+/// @brief Unit test for exporting metrics to a file and scraping them over HTTP.
+TEST(CoreSuite, MetricsExporterTest) {
+    // Prepare
+    auto path = (std::filesystem::temp_directory_path() / "cpp_playground_metrics.prom").string();
+    auto &registry = metrics::Registry::instance();
+    auto &counter = registry.counter("core_test_exports_total", "Exports counted by the unit test");
+    counter.increment(3);
+    auto sample = "core_test_exports_total " + std::to_string(counter.value()) + "\n";
+
+    // Execute
+    { metrics::FileExporter exporter{registry, path, std::chrono::seconds{60}}; }
+
+    std::ifstream file{path};
+    std::string exported{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    file.close();
+    std::filesystem::remove(path);
+
+    metrics::HttpExporter server{registry, 0};
+    auto client = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(server.port());
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    auto connected = connect(client, reinterpret_cast<const sockaddr *>(&address), sizeof(address));
+    std::string request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(client, request.data(), static_cast<int>(request.size()), 0);
+
+    std::string response;
+    char buffer[4096];
+
+    for (auto received = recv(client, buffer, sizeof(buffer), 0); received > 0; received = recv(client, buffer, sizeof(buffer), 0)) {
+        response.append(buffer, static_cast<size_t>(received));
+    }
+
+#if defined(_WIN32)
+    closesocket(client);
+#else
+    close(client);
+#endif
+
+    // Expect
+    EXPECT_NE(exported.find(sample), std::string::npos);
+    EXPECT_NE(server.port(), 0);
+    EXPECT_EQ(connected, 0);
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0UL);
+    EXPECT_NE(response.find(sample), std::string::npos);
+}
+
+/// @brief Unit test for stopping the HTTP exporter while a client is connected that never sends a request.
+TEST(CoreSuite, MetricsExporterSilentClientTest) {
+    // Prepare
+    auto server = std::make_unique<metrics::HttpExporter>(metrics::Registry::instance(), 0);
+    auto client = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(server->port());
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    auto connected = connect(client, reinterpret_cast<const sockaddr *>(&address), sizeof(address));
+
+    // Execute
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+    auto stopStart = std::chrono::steady_clock::now();
+    server.reset();
+    auto stopDuration = std::chrono::steady_clock::now() - stopStart;
+
+#if defined(_WIN32)
+    closesocket(client);
+#else
+    close(client);
+#endif
+
+    // Expect
+    EXPECT_EQ(connected, 0);
+    EXPECT_LT(stopDuration, std::chrono::seconds{1});
+}
+} // namespace
+} // namespace testing
+} // namespace core
@@ -0,0 +1,129 @@
+/// @file BatchingConsumer.h
+/// @brief C++ templates which implement a consumer adaptor that hands items to its callback in batches
+/// @details A batch is handed over once it reached the batch limit or once the linger time passed since its first item, whichever comes first.
+///          The batch limit adapts to the load: it grows towards the maximum while batches fill up and shrinks towards the observed batch size
+///          while the linger time expires. So a lightly loaded consumer hands over small batches without waiting, and a heavily loaded consumer
+///          amortizes the work of its callback over large batches. The batch buffer is reused, so batching does not allocate in steady state.
+/// @date 2025
+/// @author Michael Petersen
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+#include "ProducerConsumer.h"
+
+namespace producer_consumer {
+/// @brief Consumer adaptor that collects items from any producer-consumer into batches.
+/// @details The adaptor itself is not thread-safe, every consumer thread uses its own adaptor.
+/// @tparam ITEM   Typename for produced and consumed items, must be default constructible
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+template <typename ITEM, typename STATUS>
+class BatchingConsumer final {
+  public:
+    BatchingConsumer(IProducerConsumer<ITEM, STATUS> &source, size_t maximumBatch, std::chrono::microseconds linger);
+
+    template <typename CALLBACK>
+    ConsumerResult consume(CALLBACK &&callback, std::chrono::milliseconds timeout = std::chrono::milliseconds{0}, std::stop_token stopToken = {});
+    size_t batchLimit() const;
+
+  private:
+    void adapt(bool filled);
+
+    IProducerConsumer<ITEM, STATUS> &source;
+    const size_t maximumBatch;
+    const std::chrono::microseconds linger;
+    size_t limit;
+    std::vector<ITEM> batch;
+};
+
+/// @brief Construct a batching consumer.
+/// @tparam ITEM        Typename for produced and consumed items, must be default constructible
+/// @tparam STATUS      Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param source       Producer-consumer to consume items from, must outlive the adaptor
+/// @param maximumBatch Maximum number of items per batch, at least one
+/// @param linger       Maximum duration to wait for more items after the first item of a batch was consumed
+template <typename ITEM, typename STATUS>
+inline BatchingConsumer<ITEM, STATUS>::BatchingConsumer(IProducerConsumer<ITEM, STATUS> &source, size_t maximumBatch, std::chrono::microseconds linger)
+    : source{source}, maximumBatch{std::max<size_t>(maximumBatch, 1)}, linger{linger}, limit{this->maximumBatch} {
+    batch.reserve(this->maximumBatch);
+}
+
+/// @brief Consume a batch of items and hand it to the callback.
+/// @details The consumer waits up to the timeout for the first item and then up to the linger time for the batch to fill up.
+///          Items that are already queued are taken without waiting. If the producer finishes or the wait is stopped while a batch is collected,
+///          the partial batch is handed over and the next call reports the finished producer or the stopped wait.
+/// @tparam ITEM      Typename for produced and consumed items, must be default constructible
+/// @tparam STATUS    Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam CALLBACK  Callable that accepts a std::span<ITEM> of the batch, it may move the items out of the batch
+/// @param callback   Callable that processes the batch
+/// @param timeout    Duration in milliseconds to wait for the first item or zero for an infinite wait
+/// @param stopToken  Token to stop waiting from another thread
+/// @return           Callback processed a batch, the consumer timed out waiting for the first item, the producer has finished its work, or the wait was stopped
+template <typename ITEM, typename STATUS>
+template <typename CALLBACK>
+inline ConsumerResult BatchingConsumer<ITEM, STATUS>::consume(CALLBACK &&callback, std::chrono::milliseconds timeout, std::stop_token stopToken) {
+    ITEM item{};
+    auto result = source.consumeUntil(&item, deadlineAfter(timeout), stopToken);
+
+    if (result != ConsumerResult::Available) {
+        return result;
+    }
+
+    // a batch left over by a throwing callback is discarded and not handed over twice
+    batch.clear();
+    batch.push_back(std::move(item));
+    auto lingerDeadline = std::chrono::steady_clock::now() + linger;
+
+    while (batch.size() < limit) {
+        result = source.tryConsume(&item);
+
+        if (result == ConsumerResult::Timeout) {
+            result = source.consumeUntil(&item, lingerDeadline, stopToken);
+        }
+
+        if (result != ConsumerResult::Available) {
+            break;
+        }
+
+        batch.push_back(std::move(item));
+    }
+
+    // only a batch that filled up or lingered in vain tells something about the load
+    if (batch.size() >= limit || result == ConsumerResult::Timeout) {
+        adapt(batch.size() >= limit);
+    }
+
+    callback(std::span<ITEM>{batch});
+    batch.clear();
+    return ConsumerResult::Available;
+}
+
+/// @brief Retrieve the current batch limit.
+/// @tparam ITEM   Typename for produced and consumed items, must be default constructible
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return        Number of items after which a batch is handed over without waiting for the linger time
+template <typename ITEM, typename STATUS>
+inline size_t BatchingConsumer<ITEM, STATUS>::batchLimit() const {
+    return limit;
+}
+
+/// @brief Adapt the batch limit to the load.
+/// @details A full batch doubles the limit up to the maximum. A batch that was handed over early moves the limit halfway towards its size,
+///          so the next batch of similar size is handed over without waiting for the linger time.
+/// @tparam ITEM   Typename for produced and consumed items, must be default constructible
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param filled  The batch reached the limit
+template <typename ITEM, typename STATUS>
+inline void BatchingConsumer<ITEM, STATUS>::adapt(bool filled) {
+    if (filled) {
+        limit = std::min(limit * 2, maximumBatch);
+    } else {
+        limit = std::max<size_t>((limit + batch.size()) / 2, 1);
+    }
+}
+} // namespace producer_consumer
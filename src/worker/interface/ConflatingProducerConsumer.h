@@ -0,0 +1,281 @@
+/// @file ConflatingProducerConsumer.h
+/// @brief C++ templates which implement a thread-safe producer-consumer pattern where the latest item per key wins
+/// @details Items are identified by a key that is extracted from each item. A newer item for a key that is still waiting in the queue
+///          replaces the waiting item in place and keeps its queue position. Stale intermediate items are never delivered,
+///          so queue memory and consumer work are bounded by the number of distinct keys.
+/// @date 2025
+/// @author Michael Petersen
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <shared_mutex>
+#include <stop_token>
+#include <unordered_map>
+
+#include "ProducerConsumer.h"
+
+namespace producer_consumer {
+/// @brief Conflating Producer-Consumer pattern implemented as a thread-safe C++ class template.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+template <typename ITEM, typename STATUS, typename KEY>
+class ConflatingProducerConsumer final : public IProducerConsumer<ITEM, STATUS> {
+  public:
+    /// @brief Callback function type that extracts the conflation key from an item.
+    using KeyExtractor = std::function<KEY(const ITEM &item)>;
+
+    explicit ConflatingProducerConsumer(KeyExtractor keyOf);
+    ~ConflatingProducerConsumer() override = default;
+
+    ProducerResult produce(ITEM &&item) override;
+    ProducerResult produceAndFinish(ITEM &&item, STATUS status) override;
+    ConsumerResult consume(ITEM *item, std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) override;
+    ConsumerResult tryConsume(ITEM *item) override;
+    ConsumerResult consumeUntil(ITEM *item, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken = {}) override;
+    void finishProducer(STATUS status) override;
+    void cancelConsumer(STATUS status) override;
+    bool finished() const override;
+    bool cancelled() const override;
+    STATUS status() const override;
+    size_t count() const override;
+    size_t conflated() const;
+
+  private:
+    void enqueue(ITEM &&item);
+
+    const KeyExtractor keyOf;
+    bool isFinished{false};
+    bool isCancelled{false};
+    STATUS lastStatus{};
+    size_t conflatedCount{0};
+    mutable std::shared_timed_mutex sharedOrExclusiveAccess;
+    std::condition_variable_any itemCondition;
+    std::queue<KEY> keyQueue;
+    std::unordered_map<KEY, ITEM> latestItems;
+};
+
+/// @brief Construct a conflating producer-consumer instance.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @param keyOf   Callback that extracts the conflation key from an item
+template <typename ITEM, typename STATUS, typename KEY>
+inline ConflatingProducerConsumer<ITEM, STATUS, KEY>::ConflatingProducerConsumer(KeyExtractor keyOf) : keyOf{std::move(keyOf)} {}
+
+/// @brief Produce an item for any consumer, replacing a waiting item with the same key.
+/// @details The item is moved into the queue. If the producer is finished or the consumer is cancelled, the item is not added to the queue.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @param item    Item will be moved to the consumer
+/// @return        Consumer will take the item or is not interested (item not moved in this case)
+template <typename ITEM, typename STATUS, typename KEY>
+inline ProducerResult ConflatingProducerConsumer<ITEM, STATUS, KEY>::produce(ITEM &&item) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+
+    if (isFinished || isCancelled) {
+        return ProducerResult::Cancelled;
+    }
+
+    enqueue(std::move(item));
+    return ProducerResult::Taken;
+}
+
+/// @brief Produce an item for any consumer, replacing a waiting item with the same key, and finish the producer.
+/// @details The item is moved into the queue. If the producer is finished or the consumer is cancelled, the item is not added to the queue.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @param item    Item will be moved to the consumer
+/// @param status  Detailed status from the producer why it finished its work
+/// @return        Consumer will take the item or is not interested anymore
+template <typename ITEM, typename STATUS, typename KEY>
+inline ProducerResult ConflatingProducerConsumer<ITEM, STATUS, KEY>::produceAndFinish(ITEM &&item, STATUS status) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+
+    if (isFinished || isCancelled) {
+        return ProducerResult::Cancelled;
+    }
+
+    enqueue(std::move(item));
+    isFinished = true;
+    lastStatus = status;
+    itemCondition.notify_all();
+    return ProducerResult::Taken;
+}
+
+/// @brief Consume the latest item of the longest waiting key or wait for one until it is produced or a timeout happened.
+/// @details The item is moved from the queue. If the timeout is zero, the consumer will wait infinitely until an item is available.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @param item    Item to be consumed that will be removed from the queue
+/// @param timeout Duration in milliseconds to wait for an item to be produced or zero for an infinite wait
+/// @return        Producer has produced an item, the consumer timed out waiting for an item, or the producer has finished its work
+template <typename ITEM, typename STATUS, typename KEY>
+inline ConsumerResult ConflatingProducerConsumer<ITEM, STATUS, KEY>::consume(ITEM *item, std::chrono::milliseconds timeout) {
+    return consumeUntil(item, deadlineAfter(timeout));
+}
+
+/// @brief Consume the latest item of the longest waiting key without waiting for one.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @param item    Item to be consumed that will be removed from the queue
+/// @return        Producer has produced an item, no item is available right now, or the producer has finished its work
+template <typename ITEM, typename STATUS, typename KEY>
+inline ConsumerResult ConflatingProducerConsumer<ITEM, STATUS, KEY>::tryConsume(ITEM *item) {
+    return consumeUntil(item, std::chrono::steady_clock::time_point::min());
+}
+
+/// @brief Consume the latest item of the longest waiting key or wait for one until it is produced, the deadline passed, or the wait was stopped.
+/// @details The item is moved from the queue. A stop request on the token only wakes this consumer.
+/// @tparam ITEM      Typename for produced and consumed items
+/// @tparam STATUS    Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY       Typename for the key that identifies items which conflate, must be hashable
+/// @param item       Item to be consumed that will be removed from the queue
+/// @param deadline   Point in time to stop waiting or the maximum time point for an infinite wait
+/// @param stopToken  Token to stop waiting from another thread
+/// @return           Producer has produced an item, the consumer timed out, the producer has finished its work, or the wait was stopped
+template <typename ITEM, typename STATUS, typename KEY>
+inline ConsumerResult ConflatingProducerConsumer<ITEM, STATUS, KEY>::consumeUntil(ITEM *item, std::chrono::steady_clock::time_point deadline,
+                                                                                  std::stop_token stopToken) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+
+    if ((isFinished || isCancelled) && keyQueue.empty()) {
+        return ConsumerResult::Finished;
+    }
+
+    auto ready = [this] { return !keyQueue.empty() || isFinished || isCancelled; };
+
+    if (!ready() && deadline > std::chrono::steady_clock::now()) {
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            itemCondition.wait(writer, stopToken, ready);
+        } else {
+            itemCondition.wait_until(writer, stopToken, deadline, ready);
+        }
+    }
+
+    if (!keyQueue.empty()) {
+        auto latest = latestItems.find(keyQueue.front());
+        *item = std::move(latest->second);
+        latestItems.erase(latest);
+        keyQueue.pop();
+        return ConsumerResult::Available;
+    }
+
+    if (isFinished || isCancelled) {
+        return ConsumerResult::Finished;
+    }
+
+    return stopToken.stop_requested() ? ConsumerResult::Stopped : ConsumerResult::Timeout;
+}
+
+/// @brief This producer-consumer instance is finished and no items will be produced any more.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @param status  Detailed status from the producer why it finished its work
+template <typename ITEM, typename STATUS, typename KEY>
+inline void ConflatingProducerConsumer<ITEM, STATUS, KEY>::finishProducer(STATUS status) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+    isFinished = true;
+    lastStatus = status;
+    itemCondition.notify_all();
+}
+
+/// @brief This producer-consumer instance is cancelled and no consumer is interested in new items anymore.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @param status  Detailed status from the consumer why it cancelled its interest
+template <typename ITEM, typename STATUS, typename KEY>
+inline void ConflatingProducerConsumer<ITEM, STATUS, KEY>::cancelConsumer(STATUS status) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+    isCancelled = true;
+    lastStatus = status;
+    itemCondition.notify_all();
+}
+
+/// @brief Retrieve whether this producer-consumer instance is finished.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @return This producer-consumer instance is finished
+template <typename ITEM, typename STATUS, typename KEY>
+inline bool ConflatingProducerConsumer<ITEM, STATUS, KEY>::finished() const {
+    std::shared_lock reader{sharedOrExclusiveAccess};
+    return isFinished;
+}
+
+/// @brief Retrieve whether this producer-consumer instance is cancelled.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @return This producer-consumer instance is cancelled
+template <typename ITEM, typename STATUS, typename KEY>
+inline bool ConflatingProducerConsumer<ITEM, STATUS, KEY>::cancelled() const {
+    std::shared_lock reader{sharedOrExclusiveAccess};
+    return isCancelled;
+}
+
+/// @brief Retrieve status from last produce or consume operation.
+/// @details The status is only valid if this producer-consumer instance is finished or cancelled.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @return Status from the last finish or cancel operation
+template <typename ITEM, typename STATUS, typename KEY>
+inline STATUS ConflatingProducerConsumer<ITEM, STATUS, KEY>::status() const {
+    std::shared_lock reader{sharedOrExclusiveAccess};
+    return lastStatus;
+}
+
+/// @brief Retrieve the number of currently stored items, which is the number of distinct waiting keys.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @return Number of currently stored items
+template <typename ITEM, typename STATUS, typename KEY>
+inline size_t ConflatingProducerConsumer<ITEM, STATUS, KEY>::count() const {
+    std::shared_lock reader{sharedOrExclusiveAccess};
+    return keyQueue.size();
+}
+
+/// @brief Retrieve the number of waiting items that were replaced by a newer item with the same key.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @return Number of conflated items since construction
+template <typename ITEM, typename STATUS, typename KEY>
+inline size_t ConflatingProducerConsumer<ITEM, STATUS, KEY>::conflated() const {
+    std::shared_lock reader{sharedOrExclusiveAccess};
+    return conflatedCount;
+}
+
+/// @brief Replace the waiting item with the same key or append the item's key to the queue.
+/// @details Must be called while holding the exclusive lock. Consumers are only notified for new keys because a replacement adds no work.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam KEY    Typename for the key that identifies items which conflate, must be hashable
+/// @param item    Item will be moved into the queue
+template <typename ITEM, typename STATUS, typename KEY>
+inline void ConflatingProducerConsumer<ITEM, STATUS, KEY>::enqueue(ITEM &&item) {
+    auto key = keyOf(item);
+
+    if (auto waiting = latestItems.find(key); waiting != latestItems.end()) {
+        waiting->second = std::move(item);
+        conflatedCount++;
+        return;
+    }
+
+    latestItems.emplace(key, std::move(item));
+    keyQueue.push(std::move(key));
+    itemCondition.notify_one();
+}
+} // namespace producer_consumer
@@ -0,0 +1,594 @@
+/// @file DelayedProducerConsumer.h
+/// @brief C++ templates which implement a thread-safe producer-consumer pattern with delayed delivery of items
+/// @details Items only become consumable at a future point in time. Pending items are kept in a hierarchical timer wheel
+///          that provides O(1) insertion and amortized O(1) expiry, independent of the number of pending items.
+/// @date 2025
+/// @author Michael Petersen
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <shared_mutex>
+#include <stop_token>
+#include <vector>
+
+#include "ProducerConsumer.h"
+
+namespace producer_consumer {
+/// @brief Hierarchical timer wheel that stores items until their expiry tick has been reached.
+/// @details The wheel has 'levels' levels of 'slots' slots each. Level L covers ticks in units of slots^L, so all 64-bit ticks can be represented.
+///          An item is placed on the level of the highest digit in which its expiry tick differs from the current tick.
+///          When the current tick reaches the start of an occupied slot, its items cascade to lower levels or expire.
+///          Slot occupancy is tracked in one bitmask per level so that the next event is found without scanning slots.
+///          The wheel is not thread-safe, callers must synchronize access.
+/// @tparam ITEM Typename for stored items
+template <typename ITEM>
+class TimerWheel final {
+  public:
+    using Tick = std::uint64_t;
+
+    static constexpr size_t slotBits = 6;
+    static constexpr size_t slots = size_t{1} << slotBits;
+    static constexpr size_t levels = (std::numeric_limits<Tick>::digits + slotBits - 1) / slotBits;
+
+    void insert(ITEM &&item, Tick expiry);
+    template <typename EXPIRED>
+    void advance(Tick tick, EXPIRED &&expired);
+    std::optional<Tick> nextEvent() const;
+    Tick current() const;
+    size_t size() const;
+    void clear();
+
+  private:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    struct Node {
+        std::optional<ITEM> item;
+        Tick expiry{};
+        size_t next{npos};
+    };
+
+    struct Slot {
+        size_t head{npos};
+        size_t tail{npos};
+    };
+
+    template <typename EXPIRED>
+    void place(size_t node, EXPIRED &expired);
+    size_t allocate(ITEM &&item, Tick expiry);
+    void release(size_t node);
+
+    Tick currentTick{0};
+    size_t pendingCount{0};
+    std::array<std::uint64_t, levels> occupied{};
+    std::array<std::array<Slot, slots>, levels> wheel{};
+    std::vector<Node> nodes;
+    std::vector<size_t> freeNodes;
+};
+
+/// @brief Insert an item that expires at the given tick.
+/// @details An expiry tick that is not in the future is treated as the next tick. The node storage is recycled, so no allocation happens in steady state.
+/// @tparam ITEM Typename for stored items
+/// @param item   Item will be moved into the wheel
+/// @param expiry Tick at which the item expires
+template <typename ITEM>
+inline void TimerWheel<ITEM>::insert(ITEM &&item, Tick expiry) {
+    auto node = allocate(std::move(item), std::max(expiry, currentTick + 1));
+    auto unreachable = [](ITEM &&) {};
+    place(node, unreachable);
+    pendingCount++;
+}
+
+/// @brief Advance the current tick and hand over all items that expired on the way.
+/// @details Only ticks at which an occupied slot starts are visited, so idle periods are skipped in O(levels).
+///          Items that expire at the same tick are handed over in insertion order.
+/// @tparam ITEM    Typename for stored items
+/// @tparam EXPIRED Callable that accepts an expired item as rvalue reference
+/// @param tick     New current tick, ticks in the past are ignored
+/// @param expired  Callable that takes ownership of each expired item
+template <typename ITEM>
+template <typename EXPIRED>
+inline void TimerWheel<ITEM>::advance(Tick tick, EXPIRED &&expired) {
+    for (auto next = nextEvent(); next && *next <= tick; next = nextEvent()) {
+        currentTick = *next;
+
+        // cascade from the highest level down, so that lower levels are processed after they received items from higher levels
+        for (auto level = levels; level-- > 0;) {
+            auto shift = level * slotBits;
+
+            if (shift > 0 && (currentTick & ((Tick{1} << shift) - 1)) != 0) {
+                continue;
+            }
+
+            auto index = (currentTick >> shift) & (slots - 1);
+
+            if ((occupied[level] & (std::uint64_t{1} << index)) == 0) {
+                continue;
+            }
+
+            auto slot = wheel[level][index];
+            wheel[level][index] = Slot{};
+            occupied[level] &= ~(std::uint64_t{1} << index);
+
+            for (auto node = slot.head; node != npos;) {
+                auto following = nodes[node].next;
+                place(node, expired);
+                node = following;
+            }
+        }
+    }
+
+    currentTick = std::max(currentTick, tick);
+}
+
+/// @brief Retrieve the next tick at which an occupied slot starts.
+/// @details The tick is either the expiry of items or a cascade of items to a lower level.
+/// @tparam ITEM Typename for stored items
+/// @return Next tick at which the wheel must be advanced or nothing if the wheel is empty
+template <typename ITEM>
+inline std::optional<typename TimerWheel<ITEM>::Tick> TimerWheel<ITEM>::nextEvent() const {
+    std::optional<Tick> event;
+
+    for (size_t level = 0; level < levels; level++) {
+        auto shift = level * slotBits;
+        auto digit = (currentTick >> shift) & (slots - 1);
+        auto above = digit + 1 < slots ? occupied[level] & (~std::uint64_t{0} << (digit + 1)) : 0;
+
+        if (above == 0) {
+            continue;
+        }
+
+        auto rotation = shift + slotBits < std::numeric_limits<Tick>::digits ? (currentTick >> (shift + slotBits)) << (shift + slotBits) : 0;
+        auto start = rotation | (static_cast<Tick>(std::countr_zero(above)) << shift);
+
+        if (!event || start < *event) {
+            event = start;
+        }
+    }
+
+    return event;
+}
+
+/// @brief Retrieve the current tick of the wheel.
+/// @tparam ITEM Typename for stored items
+/// @return Current tick
+template <typename ITEM>
+inline typename TimerWheel<ITEM>::Tick TimerWheel<ITEM>::current() const {
+    return currentTick;
+}
+
+/// @brief Retrieve the number of pending items.
+/// @tparam ITEM Typename for stored items
+/// @return Number of pending items
+template <typename ITEM>
+inline size_t TimerWheel<ITEM>::size() const {
+    return pendingCount;
+}
+
+/// @brief Drop all pending items but keep the current tick.
+/// @tparam ITEM Typename for stored items
+template <typename ITEM>
+inline void TimerWheel<ITEM>::clear() {
+    occupied = {};
+    wheel = {};
+    nodes.clear();
+    freeNodes.clear();
+    pendingCount = 0;
+}
+
+/// @brief Link a node into the slot that matches its expiry tick or hand over its item if it expired.
+/// @tparam ITEM    Typename for stored items
+/// @tparam EXPIRED Callable that accepts an expired item as rvalue reference
+/// @param node     Index of the node to place
+/// @param expired  Callable that takes ownership of an expired item
+template <typename ITEM>
+template <typename EXPIRED>
+inline void TimerWheel<ITEM>::place(size_t node, EXPIRED &expired) {
+    auto expiry = nodes[node].expiry;
+
+    if (expiry <= currentTick) {
+        expired(std::move(*nodes[node].item));
+        release(node);
+        pendingCount--;
+        return;
+    }
+
+    auto level = static_cast<size_t>(std::bit_width(expiry ^ currentTick) - 1) / slotBits;
+    auto index = (expiry >> (level * slotBits)) & (slots - 1);
+    auto &slot = wheel[level][index];
+
+    nodes[node].next = npos;
+
+    if (slot.tail == npos) {
+        slot.head = node;
+    } else {
+        nodes[slot.tail].next = node;
+    }
+
+    slot.tail = node;
+    occupied[level] |= std::uint64_t{1} << index;
+}
+
+/// @brief Take a node from the free list or grow the node storage.
+/// @tparam ITEM Typename for stored items
+/// @param item   Item will be moved into the node
+/// @param expiry Tick at which the item expires
+/// @return Index of the node
+template <typename ITEM>
+inline size_t TimerWheel<ITEM>::allocate(ITEM &&item, Tick expiry) {
+    if (freeNodes.empty()) {
+        nodes.push_back(Node{std::move(item), expiry, npos});
+        return nodes.size() - 1;
+    }
+
+    auto node = freeNodes.back();
+    freeNodes.pop_back();
+    nodes[node].item.emplace(std::move(item));
+    nodes[node].expiry = expiry;
+    return node;
+}
+
+/// @brief Return a node to the free list.
+/// @tparam ITEM Typename for stored items
+/// @param node Index of the node
+template <typename ITEM>
+inline void TimerWheel<ITEM>::release(size_t node) {
+    nodes[node].item.reset();
+    freeNodes.push_back(node);
+}
+
+/// @brief Abstract class that provides the contract for a producer-consumer pattern with delayed delivery of items.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+template <typename ITEM, typename STATUS>
+class IDelayedProducerConsumer : public IProducerConsumer<ITEM, STATUS> {
+  public:
+    ~IDelayedProducerConsumer() override = default;
+    virtual ProducerResult produceAt(ITEM &&item, std::chrono::steady_clock::time_point time) = 0;
+    virtual ProducerResult produceAfter(ITEM &&item, std::chrono::steady_clock::duration delay) = 0;
+};
+
+/// @brief Producer-Consumer pattern with delayed delivery implemented as a thread-safe C++ class template.
+/// @details Items produced with 'produce' are consumable immediately, items produced with 'produceAt' or 'produceAfter' become consumable
+///          once their time has been reached. Time is measured in ticks of a configurable duration, an item never becomes consumable early.
+///          A finished producer still delivers all pending items, a cancelled consumer drops them.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+template <typename ITEM, typename STATUS>
+class DelayedProducerConsumer final : public IDelayedProducerConsumer<ITEM, STATUS> {
+  public:
+    explicit DelayedProducerConsumer(std::chrono::steady_clock::duration tick = std::chrono::milliseconds{1});
+    ~DelayedProducerConsumer() override = default;
+
+    ProducerResult produce(ITEM &&item) override;
+    ProducerResult produceAndFinish(ITEM &&item, STATUS status) override;
+    ProducerResult produceAt(ITEM &&item, std::chrono::steady_clock::time_point time) override;
+    ProducerResult produceAfter(ITEM &&item, std::chrono::steady_clock::duration delay) override;
+    ConsumerResult consume(ITEM *item, std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) override;
+    ConsumerResult tryConsume(ITEM *item) override;
+    ConsumerResult consumeUntil(ITEM *item, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken = {}) override;
+    void finishProducer(STATUS status) override;
+    void cancelConsumer(STATUS status) override;
+    bool finished() const override;
+    bool cancelled() const override;
+    STATUS status() const override;
+    size_t count() const override;
+
+  private:
+    using Tick = typename TimerWheel<ITEM>::Tick;
+
+    Tick tickOf(std::chrono::steady_clock::time_point time) const;
+    std::chrono::steady_clock::time_point timeOf(Tick tick) const;
+    void expire(std::chrono::steady_clock::time_point now);
+
+    const std::chrono::steady_clock::duration tickDuration;
+    const std::chrono::steady_clock::time_point origin;
+    bool isFinished{false};
+    bool isCancelled{false};
+    STATUS lastStatus{};
+    std::uint64_t pendingChanges{0};
+    mutable std::shared_timed_mutex sharedOrExclusiveAccess;
+    std::condition_variable_any itemCondition;
+    std::queue<ITEM> itemQueue;
+    TimerWheel<ITEM> pendingItems;
+};
+
+/// @brief Construct a producer-consumer instance with delayed delivery.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param tick    Resolution of the timer wheel, delayed items become consumable at the end of their tick
+template <typename ITEM, typename STATUS>
+inline DelayedProducerConsumer<ITEM, STATUS>::DelayedProducerConsumer(std::chrono::steady_clock::duration tick)
+    : tickDuration{std::max(tick, std::chrono::steady_clock::duration{1})}, origin{std::chrono::steady_clock::now()} {}
+
+/// @brief Produce an item for any consumer that is consumable immediately.
+/// @details The item is moved into the queue. If the producer is finished or the consumer is cancelled, the item is not added to the queue.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item    Item will be moved to the consumer
+/// @return        Consumer will take the item or is not interested (item not moved in this case)
+template <typename ITEM, typename STATUS>
+inline ProducerResult DelayedProducerConsumer<ITEM, STATUS>::produce(ITEM &&item) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+
+    if (isFinished || isCancelled) {
+        return ProducerResult::Cancelled;
+    }
+
+    itemQueue.push(std::move(item));
+    itemCondition.notify_one();
+    return ProducerResult::Taken;
+}
+
+/// @brief Produce an item for any consumer that is consumable immediately and finish the producer.
+/// @details The item is moved into the queue. If the producer is finished or the consumer is cancelled, the item is not added to the queue.
+///          Pending delayed items are still delivered after the producer finished.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item    Item will be moved to the consumer
+/// @param status  Detailed status from the producer why it finished its work
+/// @return        Consumer will take the item or is not interested anymore
+template <typename ITEM, typename STATUS>
+inline ProducerResult DelayedProducerConsumer<ITEM, STATUS>::produceAndFinish(ITEM &&item, STATUS status) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+
+    if (isFinished || isCancelled) {
+        return ProducerResult::Cancelled;
+    }
+
+    itemQueue.push(std::move(item));
+    isFinished = true;
+    lastStatus = status;
+    itemCondition.notify_all();
+    return ProducerResult::Taken;
+}
+
+/// @brief Produce an item for any consumer that becomes consumable at the given point in time.
+/// @details The item is moved into the timer wheel, or into the queue if the point in time has already passed.
+///          If the producer is finished or the consumer is cancelled, the item is not added.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item    Item will be moved to the consumer
+/// @param time    Point in time from which on the item is consumable
+/// @return        Consumer will take the item or is not interested (item not moved in this case)
+template <typename ITEM, typename STATUS>
+inline ProducerResult DelayedProducerConsumer<ITEM, STATUS>::produceAt(ITEM &&item, std::chrono::steady_clock::time_point time) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+
+    if (isFinished || isCancelled) {
+        return ProducerResult::Cancelled;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    expire(now);
+
+    if (time <= now) {
+        itemQueue.push(std::move(item));
+    } else {
+        pendingItems.insert(std::move(item), tickOf(time));
+        pendingChanges++;
+    }
+
+    // waiting consumers re-evaluate their wake-up time because the new item might expire before all other pending items
+    itemCondition.notify_one();
+    return ProducerResult::Taken;
+}
+
+/// @brief Produce an item for any consumer that becomes consumable after the given delay.
+/// @details A delay beyond the range of the steady clock saturates at its maximum time point, a negative delay makes the item consumable immediately.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item    Item will be moved to the consumer
+/// @param delay   Duration from now on after which the item is consumable
+/// @return        Consumer will take the item or is not interested (item not moved in this case)
+template <typename ITEM, typename STATUS>
+inline ProducerResult DelayedProducerConsumer<ITEM, STATUS>::produceAfter(ITEM &&item, std::chrono::steady_clock::duration delay) {
+    auto now = std::chrono::steady_clock::now();
+
+    if (delay <= std::chrono::steady_clock::duration::zero()) {
+        return produceAt(std::move(item), now);
+    }
+
+    return produceAt(std::move(item), delay < std::chrono::steady_clock::time_point::max() - now ? now + delay : std::chrono::steady_clock::time_point::max());
+}
+
+/// @brief Consume an existing item from a producer or wait for one until it is produced, it becomes due, or a timeout happened.
+/// @details The item is moved from the queue. If the timeout is zero, the consumer will wait infinitely until an item is available.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item    Item to be consumed that will be removed from the queue
+/// @param timeout Duration in milliseconds to wait for an item to be produced or zero for an infinite wait
+/// @return        Producer has produced an item, the consumer timed out waiting for an item, or the producer has finished its work
+template <typename ITEM, typename STATUS>
+inline ConsumerResult DelayedProducerConsumer<ITEM, STATUS>::consume(ITEM *item, std::chrono::milliseconds timeout) {
+    return consumeUntil(item, deadlineAfter(timeout));
+}
+
+/// @brief Consume an item that is due without waiting for one.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item    Item to be consumed that will be removed from the queue
+/// @return        An item is due, no item is due right now, or the producer has finished its work
+template <typename ITEM, typename STATUS>
+inline ConsumerResult DelayedProducerConsumer<ITEM, STATUS>::tryConsume(ITEM *item) {
+    return consumeUntil(item, std::chrono::steady_clock::time_point::min());
+}
+
+/// @brief Consume an item that is due or wait for one until it is produced, it becomes due, the deadline passed, or the wait was stopped.
+/// @details The item is moved from the queue. The consumer sleeps until the next event of the timer wheel and not longer than the deadline.
+///          A stop request on the token only wakes this consumer.
+/// @tparam ITEM      Typename for produced and consumed items
+/// @tparam STATUS    Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item       Item to be consumed that will be removed from the queue
+/// @param deadline   Point in time to stop waiting or the maximum time point for an infinite wait
+/// @param stopToken  Token to stop waiting from another thread
+/// @return           An item is due, the consumer timed out, the producer has finished its work, or the wait was stopped
+template <typename ITEM, typename STATUS>
+inline ConsumerResult DelayedProducerConsumer<ITEM, STATUS>::consumeUntil(ITEM *item, std::chrono::steady_clock::time_point deadline,
+                                                                          std::stop_token stopToken) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        expire(now);
+
+        if (!itemQueue.empty()) {
+            *item = std::move(itemQueue.front());
+            itemQueue.pop();
+
+            // several items can expire at the same tick, so hand the remaining ones to another waiting consumer
+            if (!itemQueue.empty()) {
+                itemCondition.notify_one();
+            }
+
+            return ConsumerResult::Available;
+        }
+
+        if ((isFinished || isCancelled) && pendingItems.size() == 0) {
+            return ConsumerResult::Finished;
+        }
+
+        if (stopToken.stop_requested()) {
+            return ConsumerResult::Stopped;
+        }
+
+        if (now >= deadline) {
+            return ConsumerResult::Timeout;
+        }
+
+        // sleep until the next event of the timer wheel, or until a new pending item might have moved that event forward
+        auto wakeup = deadline;
+
+        if (auto next = pendingItems.nextEvent()) {
+            wakeup = std::min(wakeup, timeOf(*next));
+        }
+
+        // a finished producer with pending items must not end the wait, so only a change of the flags since this wait began counts
+        auto changed = [this, seen = pendingChanges, wasFinished = isFinished, wasCancelled = isCancelled] {
+            return !itemQueue.empty() || isFinished != wasFinished || isCancelled != wasCancelled || pendingChanges != seen;
+        };
+
+        if (wakeup == std::chrono::steady_clock::time_point::max()) {
+            itemCondition.wait(writer, stopToken, changed);
+        } else {
+            itemCondition.wait_until(writer, stopToken, wakeup, changed);
+        }
+    }
+}
+
+/// @brief This producer-consumer instance is finished and no items will be produced any more.
+/// @details Pending delayed items are still delivered to consumers.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param status  Detailed status from the producer why it finished its work
+template <typename ITEM, typename STATUS>
+inline void DelayedProducerConsumer<ITEM, STATUS>::finishProducer(STATUS status) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+    isFinished = true;
+    lastStatus = status;
+    itemCondition.notify_all();
+}
+
+/// @brief This producer-consumer instance is cancelled and no consumer is interested in new items anymore.
+/// @details Pending delayed items are dropped.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param status  Detailed status from the consumer why it cancelled its interest
+template <typename ITEM, typename STATUS>
+inline void DelayedProducerConsumer<ITEM, STATUS>::cancelConsumer(STATUS status) {
+    std::unique_lock writer{sharedOrExclusiveAccess};
+    isCancelled = true;
+    lastStatus = status;
+    pendingItems.clear();
+    itemCondition.notify_all();
+}
+
+/// @brief Retrieve whether this producer-consumer instance is finished.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return This producer-consumer instance is finished
+template <typename ITEM, typename STATUS>
+inline bool DelayedProducerConsumer<ITEM, STATUS>::finished() const {
+    std::shared_lock reader{sharedOrExclusiveAccess};
+    return isFinished;
+}
+
+/// @brief Retrieve whether this producer-consumer instance is cancelled.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return This producer-consumer instance is cancelled
+template <typename ITEM, typename STATUS>
+inline bool DelayedProducerConsumer<ITEM, STATUS>::cancelled() const {
+    std::shared_lock reader{sharedOrExclusiveAccess};
+    return isCancelled;
+}
+
+/// @brief Retrieve status from last produce or consume operation.
+/// @details The status is only valid if this producer-consumer instance is finished or cancelled.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return Status from the last finish or cancel operation
+template <typename ITEM, typename STATUS>
+inline STATUS DelayedProducerConsumer<ITEM, STATUS>::status() const {
+    std::shared_lock reader{sharedOrExclusiveAccess};
+    return lastStatus;
+}
+
+/// @brief Retrieve the number of currently stored items from all producers, including items that are not due yet.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return Number of currently stored items
+template <typename ITEM, typename STATUS>
+inline size_t DelayedProducerConsumer<ITEM, STATUS>::count() const {
+    std::shared_lock reader{sharedOrExclusiveAccess};
+    return itemQueue.size() + pendingItems.size();
+}
+
+/// @brief Convert a point in time into the first tick that is not before it.
+/// @details The difference to the origin is computed without signed overflow, so even the maximum time point maps to a valid tick.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param time    Point in time to convert
+/// @return        Tick at which the point in time has been reached
+template <typename ITEM, typename STATUS>
+inline typename DelayedProducerConsumer<ITEM, STATUS>::Tick DelayedProducerConsumer<ITEM, STATUS>::tickOf(std::chrono::steady_clock::time_point time) const {
+    if (time <= origin) {
+        return 0;
+    }
+
+    auto elapsed = static_cast<std::uint64_t>(time.time_since_epoch().count()) - static_cast<std::uint64_t>(origin.time_since_epoch().count());
+    auto duration = static_cast<std::uint64_t>(tickDuration.count());
+    return static_cast<Tick>(elapsed / duration + (elapsed % duration != 0 ? 1 : 0));
+}
+
+/// @brief Convert a tick into the point in time at which it starts.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param tick    Tick to convert
+/// @return        Point in time at which the tick starts
+template <typename ITEM, typename STATUS>
+inline std::chrono::steady_clock::time_point DelayedProducerConsumer<ITEM, STATUS>::timeOf(Tick tick) const {
+    auto limit = static_cast<Tick>((std::chrono::steady_clock::time_point::max() - origin) / tickDuration);
+    return tick < limit ? origin + tickDuration * static_cast<std::chrono::steady_clock::rep>(tick) : std::chrono::steady_clock::time_point::max();
+}
+
+/// @brief Move all pending items that are due at the given point in time into the queue.
+/// @details Must be called while holding the exclusive lock.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param now     Current point in time
+template <typename ITEM, typename STATUS>
+inline void DelayedProducerConsumer<ITEM, STATUS>::expire(std::chrono::steady_clock::time_point now) {
+    auto elapsed = now - origin;
+    auto tick = elapsed.count() > 0 ? static_cast<Tick>(elapsed / tickDuration) : Tick{0};
+    pendingItems.advance(tick, [this](ITEM &&item) { itemQueue.push(std::move(item)); });
+}
+} // namespace producer_consumer
@@ -0,0 +1,343 @@
+/// @file MulticastRing.h
+/// @brief C++ templates which implement a thread-safe multicast ring buffer where every consumer sees every item
+/// @details The ring buffer follows the disruptor pattern. Items are stored once in a pre-allocated ring and every consumer reads them in place.
+///          Each consumer has its own cursor and the producer is gated by the slowest consumer, so no item is overwritten before all consumers saw it.
+///          A consumer can depend on other consumers and then only sees an item after all of its dependencies have processed it.
+///          Cursors and the published sequence are atomics, a mutex and a condition variable are only used if a producer or a consumer has to block.
+/// @date 2025
+/// @author Michael Petersen
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "ProducerConsumer.h"
+
+namespace producer_consumer {
+/// @brief Multicast ring buffer implemented as a thread-safe C++ class template.
+/// @details All consumers must subscribe before the first item is produced. Items must be default constructible and move assignable.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+template <typename ITEM, typename STATUS>
+class MulticastRing final {
+  public:
+    using Sequence = std::int64_t;
+    using Consumer = size_t;
+
+    explicit MulticastRing(size_t capacity);
+
+    Consumer subscribe(std::initializer_list<Consumer> dependencies = {});
+    ProducerResult produce(ITEM &&item);
+    ProducerResult produceAndFinish(ITEM &&item, STATUS status);
+    template <typename CALLBACK>
+    ConsumerResult consume(Consumer consumer, CALLBACK &&callback, std::chrono::milliseconds timeout = std::chrono::milliseconds{0});
+    void finishProducer(STATUS status);
+    void cancelConsumer(STATUS status);
+    bool finished() const;
+    bool cancelled() const;
+    STATUS status() const;
+    size_t count(Consumer consumer) const;
+    size_t capacity() const;
+
+  private:
+    /// @brief Cursor of one consumer, aligned to a cache line so that consumers do not share cache lines.
+    struct alignas(cacheLineSize) Cursor {
+        std::atomic<Sequence> sequence{-1};
+        std::vector<Consumer> dependencies;
+    };
+
+    ProducerResult publish(ITEM &&item);
+    Sequence available(const Cursor &cursor) const;
+    Sequence gate() const;
+    template <typename PREDICATE>
+    bool block(std::chrono::steady_clock::time_point deadline, PREDICATE ready);
+    void wakeup();
+
+    const Sequence mask;
+    std::vector<ITEM> ring;
+    std::deque<Cursor> cursors;
+    alignas(cacheLineSize) std::atomic<Sequence> published{-1};
+    alignas(cacheLineSize) std::atomic<size_t> waiters{0};
+    std::atomic<bool> isFinished{false};
+    std::atomic<bool> isCancelled{false};
+    STATUS lastStatus{};
+    std::mutex producerAccess;
+    mutable std::mutex waitAccess;
+    std::condition_variable waitCondition;
+};
+
+/// @brief Construct a multicast ring buffer with pre-allocated storage for its items.
+/// @tparam ITEM    Typename for produced and consumed items
+/// @tparam STATUS  Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param capacity Number of items in the ring, rounded up to the next power of two
+template <typename ITEM, typename STATUS>
+inline MulticastRing<ITEM, STATUS>::MulticastRing(size_t capacity)
+    : mask{static_cast<Sequence>(std::bit_ceil(std::max(capacity, size_t{1}))) - 1}, ring(static_cast<size_t>(mask) + 1) {}
+
+/// @brief Register a consumer that will see every item produced from now on.
+/// @details Must be called before the first item is produced or consumed.
+///          Throws std::invalid_argument if a dependency is not an already subscribed consumer, so dependencies cannot form cycles.
+/// @tparam ITEM        Typename for produced and consumed items
+/// @tparam STATUS      Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param dependencies Consumers that must have processed an item before this consumer sees it
+/// @return             Consumer handle to be passed to 'consume'
+template <typename ITEM, typename STATUS>
+inline typename MulticastRing<ITEM, STATUS>::Consumer MulticastRing<ITEM, STATUS>::subscribe(std::initializer_list<Consumer> dependencies) {
+    if (std::ranges::any_of(dependencies, [this](Consumer dependency) { return dependency >= cursors.size(); })) {
+        throw std::invalid_argument("multicast ring consumers can only depend on already subscribed consumers");
+    }
+
+    auto &cursor = cursors.emplace_back();
+    cursor.sequence.store(published.load());
+    cursor.dependencies.assign(dependencies);
+    return cursors.size() - 1;
+}
+
+/// @brief Produce an item for all consumers.
+/// @details The item is moved into the next slot of the ring. The producer blocks while the slowest consumer has not yet processed the slot's previous item.
+///          If the producer is finished or the consumer is cancelled, the item is not added to the ring.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item    Item will be moved to the consumers
+/// @return        Consumers will see the item or are not interested (item not moved in this case)
+template <typename ITEM, typename STATUS>
+inline ProducerResult MulticastRing<ITEM, STATUS>::produce(ITEM &&item) {
+    std::unique_lock producer{producerAccess};
+    return publish(std::move(item));
+}
+
+/// @brief Produce an item for all consumers and finish the producer.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item    Item will be moved to the consumers
+/// @param status  Detailed status from the producer why it finished its work
+/// @return        Consumers will see the item or are not interested anymore
+template <typename ITEM, typename STATUS>
+inline ProducerResult MulticastRing<ITEM, STATUS>::produceAndFinish(ITEM &&item, STATUS status) {
+    std::unique_lock producer{producerAccess};
+    auto result = publish(std::move(item));
+
+    if (result == ProducerResult::Taken) {
+        finishProducer(status);
+    }
+
+    return result;
+}
+
+/// @brief Process the next item for a consumer in place or wait for one until it is produced or a timeout happened.
+/// @details The callback receives a const reference to the item inside the ring. The slot is released for the producer after the callback returned.
+///          If the timeout is zero, the consumer will wait infinitely until an item is available.
+/// @tparam ITEM     Typename for produced and consumed items
+/// @tparam STATUS   Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam CALLBACK Callable that accepts a const reference to an item
+/// @param consumer  Consumer handle returned by 'subscribe'
+/// @param callback  Callable that processes the item in place
+/// @param timeout   Duration in milliseconds to wait for an item to be produced or zero for an infinite wait
+/// @return          Callback processed an item, the consumer timed out waiting for an item, or the producer has finished its work
+template <typename ITEM, typename STATUS>
+template <typename CALLBACK>
+inline ConsumerResult MulticastRing<ITEM, STATUS>::consume(Consumer consumer, CALLBACK &&callback, std::chrono::milliseconds timeout) {
+    auto &cursor = cursors[consumer];
+    auto next = cursor.sequence.load(std::memory_order_relaxed) + 1;
+
+    if (next > available(cursor)) {
+        auto deadline = timeout.count() > 0 ? std::chrono::steady_clock::now() + timeout : std::chrono::steady_clock::time_point::max();
+        auto done = [this, next] { return (isFinished.load() || isCancelled.load()) && next > published.load(); };
+
+        block(deadline, [this, &cursor, next, &done] { return next <= available(cursor) || done(); });
+
+        if (next > available(cursor)) {
+            return done() ? ConsumerResult::Finished : ConsumerResult::Timeout;
+        }
+    }
+
+    const ITEM &item = ring[static_cast<size_t>(next & mask)];
+    callback(item);
+    cursor.sequence.store(next, std::memory_order_release);
+    wakeup();
+    return ConsumerResult::Available;
+}
+
+/// @brief This ring buffer is finished and no items will be produced any more.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param status  Detailed status from the producer why it finished its work
+template <typename ITEM, typename STATUS>
+inline void MulticastRing<ITEM, STATUS>::finishProducer(STATUS status) {
+    std::unique_lock waiter{waitAccess};
+    isFinished.store(true);
+    lastStatus = status;
+    waitCondition.notify_all();
+}
+
+/// @brief This ring buffer is cancelled and no consumer is interested in new items anymore.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param status  Detailed status from the consumer why it cancelled its interest
+template <typename ITEM, typename STATUS>
+inline void MulticastRing<ITEM, STATUS>::cancelConsumer(STATUS status) {
+    std::unique_lock waiter{waitAccess};
+    isCancelled.store(true);
+    lastStatus = status;
+    waitCondition.notify_all();
+}
+
+/// @brief Retrieve whether this ring buffer is finished.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return This ring buffer is finished
+template <typename ITEM, typename STATUS>
+inline bool MulticastRing<ITEM, STATUS>::finished() const {
+    return isFinished.load();
+}
+
+/// @brief Retrieve whether this ring buffer is cancelled.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return This ring buffer is cancelled
+template <typename ITEM, typename STATUS>
+inline bool MulticastRing<ITEM, STATUS>::cancelled() const {
+    return isCancelled.load();
+}
+
+/// @brief Retrieve status from last finish or cancel operation.
+/// @details The status is only valid if this ring buffer is finished or cancelled.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return Status from the last finish or cancel operation
+template <typename ITEM, typename STATUS>
+inline STATUS MulticastRing<ITEM, STATUS>::status() const {
+    std::unique_lock waiter{waitAccess};
+    return lastStatus;
+}
+
+/// @brief Retrieve the number of produced items that a consumer has not processed yet.
+/// @tparam ITEM    Typename for produced and consumed items
+/// @tparam STATUS  Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param consumer Consumer handle returned by 'subscribe'
+/// @return         Number of items the consumer has not processed yet
+template <typename ITEM, typename STATUS>
+inline size_t MulticastRing<ITEM, STATUS>::count(Consumer consumer) const {
+    return static_cast<size_t>(published.load() - cursors[consumer].sequence.load());
+}
+
+/// @brief Retrieve the number of items the ring can hold.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return Number of items in the ring
+template <typename ITEM, typename STATUS>
+inline size_t MulticastRing<ITEM, STATUS>::capacity() const {
+    return ring.size();
+}
+
+/// @brief Move an item into the next slot as soon as all consumers released it and publish its sequence.
+/// @details Must be called while holding the producer lock.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param item    Item will be moved to the consumers
+/// @return        Consumers will see the item or are not interested (item not moved in this case)
+template <typename ITEM, typename STATUS>
+inline ProducerResult MulticastRing<ITEM, STATUS>::publish(ITEM &&item) {
+    if (isFinished.load() || isCancelled.load()) {
+        return ProducerResult::Cancelled;
+    }
+
+    auto next = published.load(std::memory_order_relaxed) + 1;
+
+    if (next - static_cast<Sequence>(ring.size()) > gate()) {
+        block(std::chrono::steady_clock::time_point::max(),
+              [this, next] { return next - static_cast<Sequence>(ring.size()) <= gate() || isFinished.load() || isCancelled.load(); });
+
+        if (isFinished.load() || isCancelled.load()) {
+            return ProducerResult::Cancelled;
+        }
+    }
+
+    ring[static_cast<size_t>(next & mask)] = std::move(item);
+    published.store(next, std::memory_order_release);
+    wakeup();
+    return ProducerResult::Taken;
+}
+
+/// @brief Retrieve the highest sequence a consumer may process, limited by the producer and by its dependencies.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @param cursor  Cursor of the consumer
+/// @return        Highest sequence the consumer may process
+template <typename ITEM, typename STATUS>
+inline typename MulticastRing<ITEM, STATUS>::Sequence MulticastRing<ITEM, STATUS>::available(const Cursor &cursor) const {
+    auto sequence = published.load(std::memory_order_acquire);
+
+    for (auto dependency : cursor.dependencies) {
+        sequence = std::min(sequence, cursors[dependency].sequence.load(std::memory_order_acquire));
+    }
+
+    return sequence;
+}
+
+/// @brief Retrieve the sequence of the slowest consumer, which gates the producer.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @return Lowest sequence processed by all consumers
+template <typename ITEM, typename STATUS>
+inline typename MulticastRing<ITEM, STATUS>::Sequence MulticastRing<ITEM, STATUS>::gate() const {
+    auto sequence = published.load(std::memory_order_relaxed);
+
+    for (const auto &cursor : cursors) {
+        sequence = std::min(sequence, cursor.sequence.load(std::memory_order_acquire));
+    }
+
+    return sequence;
+}
+
+/// @brief Block the calling thread until the predicate is satisfied or the deadline passed.
+/// @details The waiter is registered before the predicate is evaluated, and 'wakeup' checks for registered waiters after a sequence was stored.
+///          Both sides separate store and load by a sequentially consistent fence, so either the waiter sees the new sequence or the waker sees the waiter.
+/// @tparam ITEM      Typename for produced and consumed items
+/// @tparam STATUS    Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam PREDICATE Callable without parameters that returns whether waiting is over
+/// @param deadline   Point in time to stop waiting or the maximum time point for an infinite wait
+/// @param ready      Predicate that is evaluated while holding the wait lock
+/// @return           Predicate is satisfied
+template <typename ITEM, typename STATUS>
+template <typename PREDICATE>
+inline bool MulticastRing<ITEM, STATUS>::block(std::chrono::steady_clock::time_point deadline, PREDICATE ready) {
+    std::unique_lock waiter{waitAccess};
+    waiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    auto satisfied = true;
+
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+        waitCondition.wait(waiter, ready);
+    } else {
+        satisfied = waitCondition.wait_until(waiter, deadline, ready);
+    }
+
+    waiters.fetch_sub(1);
+    return satisfied;
+}
+
+/// @brief Wake up all blocked producers and consumers, but only take the wait lock if anybody is blocked.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+template <typename ITEM, typename STATUS>
+inline void MulticastRing<ITEM, STATUS>::wakeup() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (waiters.load(std::memory_order_relaxed) > 0) {
+        std::unique_lock waiter{waitAccess};
+        waitCondition.notify_all();
+    }
+}
+} // namespace producer_consumer
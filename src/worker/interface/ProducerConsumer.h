@@ -5,19 +5,50 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <concepts>
 #include <condition_variable>
+#include <mutex>
+#include <optional>
 #include <queue>
 #include <shared_mutex>
+#include <stop_token>
+#include <string>
+
+#include "Metrics.h"
+#include "Tracing.h"
 
 namespace producer_consumer {
+/// @brief Cache line size used to align data that is written by different threads.
+/// @details A fixed value instead of std::hardware_destructive_interference_size keeps the layout of public types stable across compiler flags.
+inline constexpr size_t cacheLineSize = 64;
+
 /// @brief For a producer of items, the interest of the consumer in the next item is defined through this enumeration.
 /// @details The producer is either able to produce an item or it can be informed that no consumer is interested in the item anymore.
 enum class ProducerResult { Taken, Cancelled };
 
 /// @brief For a consumer of items, the availability of the next produced item is defined through this enumeration.
 /// @details The consumer can receive an item, it can time out waiting for the next item, or it can be informed that the producer has finished its work.
-enum class ConsumerResult { Available, Timeout, Finished };
+///          A consumer that waits with a stop token is informed that its wait was stopped through the token.
+enum class ConsumerResult { Available, Timeout, Finished, Stopped };
+
+/// @brief Convert a consumer timeout into a deadline.
+/// @param timeout Duration to wait for an item to be produced or zero for an infinite wait
+/// @return        Point in time to stop waiting or the maximum time point for an infinite wait
+inline std::chrono::steady_clock::time_point deadlineAfter(std::chrono::steady_clock::duration timeout) {
+    return timeout.count() > 0 ? std::chrono::steady_clock::now() + timeout : std::chrono::steady_clock::time_point::max();
+}
+
+/// @brief Hint to the processor that the calling thread is busy-waiting.
+/// @details This reduces power consumption and frees execution resources for a hyper-thread sibling while spinning.
+inline void relaxProcessor() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
 
 /// @brief Abstract class that provides the contract for a producer-consumer pattern implementation.
 /// @tparam ITEM   Typename for produced and consumed items
@@ -28,7 +59,9 @@ class IProducerConsumer {
     virtual ~IProducerConsumer() = default;
     virtual ProducerResult produce(ITEM &&item) = 0;
     virtual ProducerResult produceAndFinish(ITEM &&item, STATUS status) = 0;
-    virtual ConsumerResult consume(ITEM *item, std::chrono::milliseconds timeout = 0) = 0;
+    virtual ConsumerResult consume(ITEM *item, std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) = 0;
+    virtual ConsumerResult tryConsume(ITEM *item) = 0;
+    virtual ConsumerResult consumeUntil(ITEM *item, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken = {}) = 0;
     virtual void finishProducer(STATUS status) = 0;
     virtual void cancelConsumer(STATUS status) = 0;
     virtual bool finished() const = 0;
@@ -37,17 +70,76 @@ class IProducerConsumer {
     virtual size_t count() const = 0;
 };
 
+/// @brief Concept for producer-consumer types that can be used in generic code without virtual dispatch.
+/// @details Generic code constrained by this concept can be instantiated with a final implementation, so that its calls are devirtualized and inlined,
+///          or with IProducerConsumer, so that it can still be tested with mocks.
+/// @tparam T      Type to check
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+template <typename T, typename ITEM, typename STATUS>
+concept ProducerConsumerLike = requires(T &producerConsumer, const T &constProducerConsumer, ITEM &&item, ITEM *consumed, STATUS status,
+                                        std::chrono::milliseconds timeout, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken) {
+    { producerConsumer.produce(std::move(item)) } -> std::same_as<ProducerResult>;
+    { producerConsumer.produceAndFinish(std::move(item), status) } -> std::same_as<ProducerResult>;
+    { producerConsumer.consume(consumed, timeout) } -> std::same_as<ConsumerResult>;
+    { producerConsumer.tryConsume(consumed) } -> std::same_as<ConsumerResult>;
+    { producerConsumer.consumeUntil(consumed, deadline, stopToken) } -> std::same_as<ConsumerResult>;
+    producerConsumer.finishProducer(status);
+    producerConsumer.cancelConsumer(status);
+    { constProducerConsumer.finished() } -> std::convertible_to<bool>;
+    { constProducerConsumer.cancelled() } -> std::convertible_to<bool>;
+    { constProducerConsumer.status() } -> std::convertible_to<STATUS>;
+    { constProducerConsumer.count() } -> std::convertible_to<size_t>;
+};
+
+/// @brief Handle to an item that a consumer borrowed from a producer-consumer instance.
+/// @details The item was moved out of the queue storage, so it is processed without holding any lock of the queue.
+///          The item is destroyed together with the handle or when the handle borrows the next item.
+/// @tparam ITEM Typename for produced and consumed items
+template <typename ITEM>
+class BorrowedItem final {
+  public:
+    BorrowedItem() = default;
+    BorrowedItem(BorrowedItem &&) noexcept = default;
+    BorrowedItem &operator=(BorrowedItem &&) noexcept = default;
+    BorrowedItem(const BorrowedItem &) = delete;
+    BorrowedItem &operator=(const BorrowedItem &) = delete;
+
+    /// @brief Retrieve whether the handle holds an item.
+    /// @return An item was borrowed and not yet released
+    explicit operator bool() const { return item.has_value(); }
+    /// @brief Access the borrowed item, the handle must hold an item.
+    /// @return Reference to the borrowed item
+    ITEM &operator*() { return *item; }
+    /// @brief Access the borrowed item, the handle must hold an item.
+    /// @return Pointer to the borrowed item
+    ITEM *operator->() { return &*item; }
+    /// @brief Destroy the borrowed item before the handle goes out of scope.
+    void release() { item.reset(); }
+
+  private:
+    template <typename, typename, typename>
+    friend class ProducerConsumer;
+
+    std::optional<ITEM> item;
+};
+
 /// @brief Producer-Consumer pattern implemented as a thread-safe C++ class template.
+/// @details Latency-sensitive consumers can busy-wait for a bounded duration before they block, which avoids the wake-up latency of the operating system.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
-template <typename ITEM, typename STATUS>
+/// @tparam QUEUE  Storage typename with the interface of std::queue
+template <typename ITEM, typename STATUS, typename QUEUE = std::queue<ITEM>>
 class ProducerConsumer final : public IProducerConsumer<ITEM, STATUS> {
   public:
-    ~ProducerConsumer() override = default;
+    explicit ProducerConsumer(std::chrono::nanoseconds spinDuration = std::chrono::nanoseconds{0});
+    ~ProducerConsumer() override;
 
     ProducerResult produce(ITEM &&item) override;
     ProducerResult produceAndFinish(ITEM &&item, STATUS status) override;
-    ConsumerResult consume(ITEM *item, std::chrono::milliseconds timeout = 0) override;
+    ConsumerResult consume(ITEM *item, std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) override;
+    ConsumerResult tryConsume(ITEM *item) override;
+    ConsumerResult consumeUntil(ITEM *item, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken = {}) override;
     void finishProducer(STATUS status) override;
     void cancelConsumer(STATUS status) override;
     bool finished() const override;
@@ -55,31 +147,76 @@ class ProducerConsumer final : public IProducerConsumer<ITEM, STATUS> {
     STATUS status() const override;
     size_t count() const override;
 
+    template <typename... ARGS>
+    ProducerResult emplace(ARGS &&...args);
+    template <typename CALLBACK>
+    ConsumerResult consumeBorrowed(CALLBACK &&callback, std::chrono::milliseconds timeout = std::chrono::milliseconds{0});
+    template <typename CALLBACK>
+    ConsumerResult consumeBorrowedUntil(CALLBACK &&callback, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken = {});
+    ConsumerResult borrowUntil(BorrowedItem<ITEM> *borrowed, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken = {});
+    void trim()
+        requires requires(QUEUE &queue) { queue.trim(); };
+    void instrument(metrics::Registry &registry, const std::string &name);
+
   private:
+    ConsumerResult waitForItem(std::unique_lock<std::shared_timed_mutex> &writer, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken);
+    void spinForItem(std::chrono::steady_clock::time_point deadline, const std::stop_token &stopToken) const;
+    void countItems(metrics::Counter *operations, double queuedChange);
+
+    const std::chrono::nanoseconds spinDuration;
+    std::atomic<size_t> availableItems{0};
+    std::atomic<bool> isClosed{false}; // mirrors isFinished || isCancelled for spinning consumers
     bool isFinished{false};
     bool isCancelled{false};
     STATUS lastStatus{};
     mutable std::shared_timed_mutex sharedOrExclusiveAccess;
     std::condition_variable_any itemCondition;
-    std::queue<ITEM> itemQueue;
+    QUEUE itemQueue;
+    metrics::Counter *producedItems{nullptr};
+    metrics::Counter *consumedItems{nullptr};
+    metrics::Gauge *queuedItems{nullptr};
 };
 
+/// @brief Construct a producer-consumer instance.
+/// @tparam ITEM        Typename for produced and consumed items
+/// @tparam STATUS      Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE       Storage typename with the interface of std::queue
+/// @param spinDuration Maximum duration a consumer busy-waits for an item before it blocks, zero to block immediately
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline ProducerConsumer<ITEM, STATUS, QUEUE>::ProducerConsumer(std::chrono::nanoseconds spinDuration) : spinDuration{spinDuration} {}
+
+/// @brief Destroy a producer-consumer instance.
+/// @details The items that are still queued are removed from the queued items metric, which other instances with the same name might share.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline ProducerConsumer<ITEM, STATUS, QUEUE>::~ProducerConsumer() {
+    if (queuedItems != nullptr) {
+        queuedItems->add(-static_cast<double>(itemQueue.size()));
+    }
+}
+
 /// @brief Produce an item for any consumer.
 /// @details The item is moved into the queue. If the producer is finished or the consumer is cancelled, the item is not added to the queue.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
 /// @param item    Item will be moved to the consumer
 /// @return        Consumer will take the item or is not interested (item not moved in this case)
-template <typename ITEM, typename STATUS>
-inline ProducerResult ProducerConsumer<ITEM, STATUS>::produce(ITEM &&item) {
-    std::unique_lock writer{sharedOrExclusiveAccess};
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline ProducerResult ProducerConsumer<ITEM, STATUS, QUEUE>::produce(ITEM &&item) {
+    auto writer = tracing::lockExclusive(sharedOrExclusiveAccess, this);
 
     if (isFinished || isCancelled) {
         return ProducerResult::Cancelled;
     }
 
     itemQueue.push(std::move(item));
+    availableItems.store(itemQueue.size(), std::memory_order_release);
+    countItems(producedItems, 1.0);
     itemCondition.notify_one();
+    TRACE_EVENT("produce", tracing::Phase::Instant, this);
     return ProducerResult::Taken;
 }
 
@@ -87,21 +224,27 @@ inline ProducerResult ProducerConsumer<ITEM, STATUS>::produce(ITEM &&item) {
 /// @details The item is moved into the queue. If the producer is finished or the consumer is cancelled, the item is not added to the queue.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
 /// @param item    Item will be moved to the consumer
 /// @param status  Detailed status from the producer why it finished its work
 /// @return        Consumer will take the item or is not interested anymore
-template <typename ITEM, typename STATUS>
-inline ProducerResult ProducerConsumer<ITEM, STATUS>::produceAndFinish(ITEM &&item, STATUS status) {
-    std::unique_lock writer{sharedOrExclusiveAccess};
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline ProducerResult ProducerConsumer<ITEM, STATUS, QUEUE>::produceAndFinish(ITEM &&item, STATUS status) {
+    auto writer = tracing::lockExclusive(sharedOrExclusiveAccess, this);
 
     if (isFinished || isCancelled) {
         return ProducerResult::Cancelled;
     }
 
     itemQueue.push(std::move(item));
+    availableItems.store(itemQueue.size(), std::memory_order_release);
+    countItems(producedItems, 1.0);
     isFinished = true;
+    isClosed.store(true, std::memory_order_release);
     lastStatus = status;
     itemCondition.notify_all();
+    TRACE_EVENT("produce", tracing::Phase::Instant, this);
+    TRACE_EVENT("finish", tracing::Phase::Instant, this);
     return ProducerResult::Taken;
 }
 
@@ -110,33 +253,92 @@ inline ProducerResult ProducerConsumer<ITEM, STATUS>::produceAndFinish(ITEM &&it
 ///          If the timeout is zero, the consumer will wait infinitely until an item is available.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
 /// @param item    Item to be consumed that will be removed from the queue
 /// @param timeout Duration in milliseconds to wait for an item to be produced or zero for an infinite wait
 /// @return        Producer has produced an item, the consumer timed out waiting for an item, or the producer has finished its work
-template <typename ITEM, typename STATUS>
-inline ConsumerResult ProducerConsumer<ITEM, STATUS>::consume(ITEM *item, std::chrono::milliseconds timeout) {
-    std::unique_lock writer{sharedOrExclusiveAccess};
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline ConsumerResult ProducerConsumer<ITEM, STATUS, QUEUE>::consume(ITEM *item, std::chrono::milliseconds timeout) {
+    return consumeUntil(item, deadlineAfter(timeout));
+}
 
+/// @brief Consume an existing item from a producer without waiting for one.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
+/// @param item    Item to be consumed that will be removed from the queue
+/// @return        Producer has produced an item, no item is available right now, or the producer has finished its work
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline ConsumerResult ProducerConsumer<ITEM, STATUS, QUEUE>::tryConsume(ITEM *item) {
+    return consumeUntil(item, std::chrono::steady_clock::time_point::min());
+}
+
+/// @brief Consume an existing item from a producer or wait for one until it is produced, the deadline passed, or the wait was stopped.
+/// @details The item is moved from the queue. The deadline has the resolution of the steady clock, a deadline in the past does not wait at all.
+///          With a spin duration the consumer busy-waits up to that duration before it blocks. A stop request on the token only wakes this consumer.
+/// @tparam ITEM      Typename for produced and consumed items
+/// @tparam STATUS    Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE     Storage typename with the interface of std::queue
+/// @param item       Item to be consumed that will be removed from the queue
+/// @param deadline   Point in time to stop waiting or the maximum time point for an infinite wait
+/// @param stopToken  Token to stop waiting from another thread
+/// @return           Producer has produced an item, the consumer timed out, the producer has finished its work, or the wait was stopped
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline ConsumerResult ProducerConsumer<ITEM, STATUS, QUEUE>::consumeUntil(ITEM *item, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken) {
+    spinForItem(deadline, stopToken);
+
+    auto writer = tracing::lockExclusive(sharedOrExclusiveAccess, this);
+    auto result = waitForItem(writer, deadline, std::move(stopToken));
+
+    if (result == ConsumerResult::Available) {
+        *item = std::move(itemQueue.front());
+        itemQueue.pop();
+        availableItems.store(itemQueue.size(), std::memory_order_release);
+        countItems(consumedItems, -1.0);
+        TRACE_EVENT("consume", tracing::Phase::Instant, this);
+    }
+
+    return result;
+}
+
+/// @brief Wait until an item is at the front of the queue, the producer has finished its work, a deadline passed, or the wait was stopped.
+/// @details Must be called while holding the exclusive lock, which is still held when this function returns.
+/// @tparam ITEM     Typename for produced and consumed items
+/// @tparam STATUS   Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE    Storage typename with the interface of std::queue
+/// @param writer    Exclusive lock that is released while waiting
+/// @param deadline  Point in time to stop waiting or the maximum time point for an infinite wait
+/// @param stopToken Token to stop waiting from another thread
+/// @return          Item is at the front of the queue, the consumer timed out, the producer has finished its work, or the wait was stopped
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline ConsumerResult ProducerConsumer<ITEM, STATUS, QUEUE>::waitForItem(std::unique_lock<std::shared_timed_mutex> &writer,
+                                                                  std::chrono::steady_clock::time_point deadline, std::stop_token stopToken) {
     if ((isFinished || isCancelled) && itemQueue.empty()) {
         return ConsumerResult::Finished;
     }
 
     // Wait for a new item to be produced or for a producer to finish or for a consumer to cancel:
-    //   1. Release the unique lock 'writer' and wait for 'itemCondition.notify*()' (atomic operation)
-    //   2. If 'itemCondition.wait*()' wakes up internally (notify, spurious), acquire unique lock 'writer'
+    //   1. Release the unique lock 'writer' and wait for 'itemCondition.notify*()' or a stop request (atomic operation)
+    //   2. If 'itemCondition.wait*()' wakes up internally (notify, stop request, spurious), acquire unique lock 'writer'
     //   3. Call lamba and evaluate its return value while holding the unique lock 'writer'
-    //   4. If lambda returns false, release the unique lock 'writer' and wait again (atomic operation)
+    //   4. If lambda returns false and no stop was requested, release the unique lock 'writer' and wait again (atomic operation)
     //   5. If lambda returns true, keep the unique lock 'writer' acquired and continue
     //   6. If 'itemCondition.wait*()' wakes up externally (timeout), keep unique lock 'writer' acquired and continue
-    if (timeout.count() > 0) {
-        itemCondition.wait_for(writer, timeout, [this] { return !itemQueue.empty() || isFinished || isCancelled; });
-    } else {
-        itemCondition.wait(writer, [this] { return !itemQueue.empty() || isFinished || isCancelled; });
+    auto ready = [this] { return !itemQueue.empty() || isFinished || isCancelled; };
+
+    if (!ready() && deadline > std::chrono::steady_clock::now()) {
+        TRACE_EVENT("consume wait", tracing::Phase::Begin, this);
+
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            itemCondition.wait(writer, stopToken, ready);
+        } else {
+            itemCondition.wait_until(writer, stopToken, deadline, ready);
+        }
+
+        TRACE_EVENT("consume wait", tracing::Phase::End, this);
     }
 
     if (!itemQueue.empty()) {
-        *item = std::move(itemQueue.front());
-        itemQueue.pop();
         return ConsumerResult::Available;
     }
 
@@ -144,39 +346,76 @@ inline ConsumerResult ProducerConsumer<ITEM, STATUS>::consume(ITEM *item, std::c
         return ConsumerResult::Finished;
     }
 
+    if (stopToken.stop_requested()) {
+        TRACE_EVENT("stopped", tracing::Phase::Instant, this);
+        return ConsumerResult::Stopped;
+    }
+
+    TRACE_EVENT("timeout", tracing::Phase::Instant, this);
     return ConsumerResult::Timeout;
 }
 
+/// @brief Busy-wait until an item is available, the producer finished, the consumer cancelled, the spin duration or the deadline passed, or the wait was stopped.
+/// @details The number of available items and whether the instance is finished or cancelled are mirrored in atomics,
+///          so spinning does not contend for the lock with producers.
+/// @tparam ITEM     Typename for produced and consumed items
+/// @tparam STATUS   Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE    Storage typename with the interface of std::queue
+/// @param deadline  Point in time to stop waiting
+/// @param stopToken Token to stop waiting from another thread
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline void ProducerConsumer<ITEM, STATUS, QUEUE>::spinForItem(std::chrono::steady_clock::time_point deadline, const std::stop_token &stopToken) const {
+    auto now = std::chrono::steady_clock::now();
+
+    if (spinDuration.count() <= 0 || deadline <= now || availableItems.load(std::memory_order_acquire) > 0 || isClosed.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    auto spinEnd = deadline - now > spinDuration ? now + spinDuration : deadline;
+
+    while (availableItems.load(std::memory_order_acquire) == 0 && !isClosed.load(std::memory_order_acquire) && !stopToken.stop_requested() &&
+           std::chrono::steady_clock::now() < spinEnd) {
+        relaxProcessor();
+    }
+}
+
 /// @brief This producer-consumer instance is finished and no items will be produced any more.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
 /// @param status
-template <typename ITEM, typename STATUS>
-inline void ProducerConsumer<ITEM, STATUS>::finishProducer(STATUS status) {
-    std::unique_lock writer{sharedOrExclusiveAccess};
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline void ProducerConsumer<ITEM, STATUS, QUEUE>::finishProducer(STATUS status) {
+    auto writer = tracing::lockExclusive(sharedOrExclusiveAccess, this);
     isFinished = true;
+    isClosed.store(true, std::memory_order_release);
     lastStatus = status;
     itemCondition.notify_all();
+    TRACE_EVENT("finish", tracing::Phase::Instant, this);
 }
 
 /// @brief This producer-consumer instance is cancelled and no consumer is interested in new items anymore.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
 /// @param status
-template <typename ITEM, typename STATUS>
-inline void ProducerConsumer<ITEM, STATUS>::cancelConsumer(STATUS status) {
-    std::unique_lock writer{sharedOrExclusiveAccess};
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline void ProducerConsumer<ITEM, STATUS, QUEUE>::cancelConsumer(STATUS status) {
+    auto writer = tracing::lockExclusive(sharedOrExclusiveAccess, this);
     isCancelled = true;
+    isClosed.store(true, std::memory_order_release);
     lastStatus = status;
     itemCondition.notify_all();
+    TRACE_EVENT("cancel", tracing::Phase::Instant, this);
 }
 
 /// @brief Retrieve whether this producer-consumer instance is finished.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
 /// @return This producer-consumer instance is finished
-template <typename ITEM, typename STATUS>
-inline bool ProducerConsumer<ITEM, STATUS>::finished() const {
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline bool ProducerConsumer<ITEM, STATUS, QUEUE>::finished() const {
     std::shared_lock reader{sharedOrExclusiveAccess};
     return isFinished;
 }
@@ -184,9 +423,10 @@ inline bool ProducerConsumer<ITEM, STATUS>::finished() const {
 /// @brief Retrieve whether this producer-consumer instance is cancelled.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
 /// @return This producer-consumer instance is cancelled
-template <typename ITEM, typename STATUS>
-inline bool ProducerConsumer<ITEM, STATUS>::cancelled() const {
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline bool ProducerConsumer<ITEM, STATUS, QUEUE>::cancelled() const {
     std::shared_lock reader{sharedOrExclusiveAccess};
     return isCancelled;
 }
@@ -195,9 +435,10 @@ inline bool ProducerConsumer<ITEM, STATUS>::cancelled() const {
 /// @details The status is only valid if this producer-consumer instance is finished or cancelled.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
 /// @return
-template <typename ITEM, typename STATUS>
-inline STATUS ProducerConsumer<ITEM, STATUS>::status() const {
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline STATUS ProducerConsumer<ITEM, STATUS, QUEUE>::status() const {
     std::shared_lock reader{sharedOrExclusiveAccess};
     return lastStatus;
 }
@@ -205,10 +446,167 @@ inline STATUS ProducerConsumer<ITEM, STATUS>::status() const {
 /// @brief Retrieve the number of currently stored items from all producers.
 /// @tparam ITEM   Typename for produced and consumed items
 /// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
 /// @return Number of currently stored items
-template <typename ITEM, typename STATUS>
-inline size_t ProducerConsumer<ITEM, STATUS>::count() const {
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline size_t ProducerConsumer<ITEM, STATUS, QUEUE>::count() const {
     std::shared_lock reader{sharedOrExclusiveAccess};
     return itemQueue.size();
 }
-} // namespace producer_consumer
\ No newline at end of file
+
+/// @brief Produce an item for any consumer by constructing it directly in the queue storage.
+/// @details The item is constructed from the arguments without a temporary. If the producer is finished or the consumer is cancelled, no item is constructed.
+/// @tparam ITEM    Typename for produced and consumed items
+/// @tparam STATUS  Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE   Storage typename with the interface of std::queue
+/// @tparam ...ARGS Declares template parameter pack of types for the constructor arguments of ITEM
+/// @param ...args  Declares function parameter pack, using forwarding references
+/// @return         Consumer will take the item or is not interested (no item constructed in this case)
+template <typename ITEM, typename STATUS, typename QUEUE>
+template <typename... ARGS>
+inline ProducerResult ProducerConsumer<ITEM, STATUS, QUEUE>::emplace(ARGS &&...args) {
+    auto writer = tracing::lockExclusive(sharedOrExclusiveAccess, this);
+
+    if (isFinished || isCancelled) {
+        return ProducerResult::Cancelled;
+    }
+
+    itemQueue.emplace(std::forward<ARGS>(args)...);
+    availableItems.store(itemQueue.size(), std::memory_order_release);
+    countItems(producedItems, 1.0);
+    itemCondition.notify_one();
+    TRACE_EVENT("produce", tracing::Phase::Instant, this);
+    return ProducerResult::Taken;
+}
+
+/// @brief Consume an existing item without a default-constructed destination or wait for one until it is produced or a timeout happened.
+/// @details The item is moved once from the queue into a borrowed handle and the callback processes it after the exclusive lock was released,
+///          see 'borrowUntil'. If the timeout is zero, the consumer will wait infinitely until an item is available.
+/// @tparam ITEM     Typename for produced and consumed items
+/// @tparam STATUS   Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE    Storage typename with the interface of std::queue
+/// @tparam CALLBACK Callable that accepts a reference to an item
+/// @param callback  Callable that processes the item, it may move the item
+/// @param timeout   Duration in milliseconds to wait for an item to be produced or zero for an infinite wait
+/// @return          Callback processed an item, the consumer timed out waiting for an item, or the producer has finished its work
+template <typename ITEM, typename STATUS, typename QUEUE>
+template <typename CALLBACK>
+inline ConsumerResult ProducerConsumer<ITEM, STATUS, QUEUE>::consumeBorrowed(CALLBACK &&callback, std::chrono::milliseconds timeout) {
+    return consumeBorrowedUntil(std::forward<CALLBACK>(callback), deadlineAfter(timeout));
+}
+
+/// @brief Consume an existing item without a default-constructed destination or wait for one until it is produced, the deadline passed, or the wait was stopped.
+/// @details The item is moved once from the queue into a borrowed handle and the callback processes it after the exclusive lock was released,
+///          see 'borrowUntil'.
+/// @tparam ITEM      Typename for produced and consumed items
+/// @tparam STATUS    Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE     Storage typename with the interface of std::queue
+/// @tparam CALLBACK  Callable that accepts a reference to an item
+/// @param callback   Callable that processes the item, it may move the item
+/// @param deadline   Point in time to stop waiting or the maximum time point for an infinite wait
+/// @param stopToken  Token to stop waiting from another thread
+/// @return           Callback processed an item, the consumer timed out, the producer has finished its work, or the wait was stopped
+template <typename ITEM, typename STATUS, typename QUEUE>
+template <typename CALLBACK>
+inline ConsumerResult ProducerConsumer<ITEM, STATUS, QUEUE>::consumeBorrowedUntil(CALLBACK &&callback, std::chrono::steady_clock::time_point deadline,
+                                                                                  std::stop_token stopToken) {
+    BorrowedItem<ITEM> borrowed;
+    auto result = borrowUntil(&borrowed, deadline, std::move(stopToken));
+
+    if (result == ConsumerResult::Available) {
+        callback(*borrowed);
+    }
+
+    return result;
+}
+
+/// @brief Borrow an existing item from a producer or wait for one until it is produced, the deadline passed, or the wait was stopped.
+/// @details While holding the exclusive lock, the item at the front is moved into the handle and removed from the queue. The storage of std::queue
+///          has no node that could be unlinked, so this single move is the price for not holding the lock while the item is processed. No destination
+///          is default-constructed. The consumer then processes the item without holding the lock, so a heavy payload blocks neither producers nor
+///          other consumers. An item that the handle still holds is destroyed before the next item is borrowed.
+/// @tparam ITEM      Typename for produced and consumed items
+/// @tparam STATUS    Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE     Storage typename with the interface of std::queue
+/// @param borrowed   Handle that receives the item
+/// @param deadline   Point in time to stop waiting or the maximum time point for an infinite wait
+/// @param stopToken  Token to stop waiting from another thread
+/// @return           Handle holds an item, the consumer timed out, the producer has finished its work, or the wait was stopped
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline ConsumerResult ProducerConsumer<ITEM, STATUS, QUEUE>::borrowUntil(BorrowedItem<ITEM> *borrowed, std::chrono::steady_clock::time_point deadline,
+                                                                         std::stop_token stopToken) {
+    borrowed->release();
+    spinForItem(deadline, stopToken);
+
+    auto writer = tracing::lockExclusive(sharedOrExclusiveAccess, this);
+    auto result = waitForItem(writer, deadline, std::move(stopToken));
+
+    if (result == ConsumerResult::Available) {
+        borrowed->item.emplace(std::move(itemQueue.front()));
+        itemQueue.pop();
+        availableItems.store(itemQueue.size(), std::memory_order_release);
+        countItems(consumedItems, -1.0);
+        TRACE_EVENT("consume", tracing::Phase::Instant, this);
+    }
+
+    return result;
+}
+
+/// @brief Release storage that the queue keeps for reuse, e.g. after a burst of items was consumed.
+/// @details Only available if the storage typename supports trimming.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE  Storage typename with the interface of std::queue
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline void ProducerConsumer<ITEM, STATUS, QUEUE>::trim()
+    requires requires(QUEUE &queue) { queue.trim(); }
+{
+    auto writer = tracing::lockExclusive(sharedOrExclusiveAccess, this);
+    itemQueue.trim();
+}
+
+/// @brief Register metrics for produced, consumed, and queued items of this instance.
+/// @details The metrics are labelled with the name of the queue. Instances with the same name share their metrics,
+///          so the counters sum up their operations and the gauge sums up their queued items.
+///          Instrumenting an instance again moves its queued items from the previous gauge to the new one.
+/// @tparam ITEM     Typename for produced and consumed items
+/// @tparam STATUS   Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE    Storage typename with the interface of std::queue
+/// @param registry  Registry to register the metrics with
+/// @param name      Name of the queue that is used as label value
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline void ProducerConsumer<ITEM, STATUS, QUEUE>::instrument(metrics::Registry &registry, const std::string &name) {
+    auto labels = "queue=\"" + name + "\"";
+    auto produced = &registry.counter("producer_consumer_produced_items_total", "Items produced into a producer-consumer queue", labels);
+    auto consumed = &registry.counter("producer_consumer_consumed_items_total", "Items consumed from a producer-consumer queue", labels);
+    auto queued = &registry.gauge("producer_consumer_queued_items", "Items waiting in a producer-consumer queue", labels);
+
+    auto writer = tracing::lockExclusive(sharedOrExclusiveAccess, this);
+    auto size = static_cast<double>(itemQueue.size());
+
+    if (queuedItems != nullptr) {
+        queuedItems->add(-size);
+    }
+
+    producedItems = produced;
+    consumedItems = consumed;
+    queuedItems = queued;
+    queuedItems->add(size);
+}
+
+/// @brief Count a produce or consume operation and update the number of queued items, if metrics are registered.
+/// @details Must be called while holding the exclusive lock. The gauge is updated by the change and not set to the size of this queue,
+///          because instances with the same name share the gauge.
+/// @tparam ITEM        Typename for produced and consumed items
+/// @tparam STATUS      Status typename when the producer finishes its work or the consumer cancels its interest
+/// @tparam QUEUE       Storage typename with the interface of std::queue
+/// @param operations   Counter of the operation, null if no metrics are registered
+/// @param queuedChange Change of the number of queued items
+template <typename ITEM, typename STATUS, typename QUEUE>
+inline void ProducerConsumer<ITEM, STATUS, QUEUE>::countItems(metrics::Counter *operations, double queuedChange) {
+    if (operations != nullptr) {
+        operations->increment();
+        queuedItems->add(queuedChange);
+    }
+}
+} // namespace producer_consumer
@@ -7,6 +7,7 @@
 
 #include <gmock/gmock.h>
 
+#include "DelayedProducerConsumer.h"
 #include "ProducerConsumer.h"
 
 using namespace producer_consumer;
@@ -21,6 +22,29 @@ class ProducerConsumerMock : public IProducerConsumer<ITEM, STATUS> {
     MOCK_METHOD(ProducerResult, produce, (ITEM && item), (override));
     MOCK_METHOD(ProducerResult, produceAndFinish, (ITEM && item, STATUS status), (override));
     MOCK_METHOD(ConsumerResult, consume, (ITEM * item, std::chrono::milliseconds timeout), (override));
+    MOCK_METHOD(ConsumerResult, tryConsume, (ITEM * item), (override));
+    MOCK_METHOD(ConsumerResult, consumeUntil, (ITEM * item, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken), (override));
+    MOCK_METHOD(void, finishProducer, (STATUS status), (override));
+    MOCK_METHOD(void, cancelConsumer, (STATUS status), (override));
+    MOCK_METHOD(bool, finished, (), (const, override));
+    MOCK_METHOD(bool, cancelled, (), (const, override));
+    MOCK_METHOD(STATUS, status, (), (const, override));
+    MOCK_METHOD(size_t, count, (), (const, override));
+};
+
+/// @brief Mock C++ class template for a producer-consumer pattern implementation with delayed delivery of items.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+template <typename ITEM, typename STATUS>
+class DelayedProducerConsumerMock : public IDelayedProducerConsumer<ITEM, STATUS> {
+  public:
+    MOCK_METHOD(ProducerResult, produce, (ITEM && item), (override));
+    MOCK_METHOD(ProducerResult, produceAndFinish, (ITEM && item, STATUS status), (override));
+    MOCK_METHOD(ProducerResult, produceAt, (ITEM && item, std::chrono::steady_clock::time_point time), (override));
+    MOCK_METHOD(ProducerResult, produceAfter, (ITEM && item, std::chrono::steady_clock::duration delay), (override));
+    MOCK_METHOD(ConsumerResult, consume, (ITEM * item, std::chrono::milliseconds timeout), (override));
+    MOCK_METHOD(ConsumerResult, tryConsume, (ITEM * item), (override));
+    MOCK_METHOD(ConsumerResult, consumeUntil, (ITEM * item, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken), (override));
     MOCK_METHOD(void, finishProducer, (STATUS status), (override));
     MOCK_METHOD(void, cancelConsumer, (STATUS status), (override));
     MOCK_METHOD(bool, finished, (), (const, override));
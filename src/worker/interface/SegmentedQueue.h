@@ -0,0 +1,250 @@
+/// @file SegmentedQueue.h
+/// @brief C++ templates which implement an unbounded FIFO queue that recycles its storage instead of returning it to the allocator
+/// @details Items are stored in fixed-size, cache-line aligned segments that are linked into a list. A segment that was drained by consumers
+///          is kept in a free list and reused by producers, so a new segment is only allocated when the queue grows beyond its high-water mark.
+///          In steady state, producing and consuming items does not call the allocator at all. Idle segments can be released explicitly.
+///          The queue is not thread-safe on its own and serves as storage of a ProducerConsumer instance.
+/// @date 2025
+/// @author Michael Petersen
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "ProducerConsumer.h"
+
+namespace producer_consumer {
+/// @brief Unbounded FIFO queue built from recycled segments, a drop-in replacement for std::queue as ProducerConsumer storage.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+template <typename ITEM, size_t SEGMENT_ITEMS = 64>
+class SegmentedQueue final {
+  public:
+    static_assert(SEGMENT_ITEMS > 0, "a segment must hold at least one item");
+
+    SegmentedQueue() = default;
+    ~SegmentedQueue();
+    SegmentedQueue(const SegmentedQueue &) = delete;
+    SegmentedQueue &operator=(const SegmentedQueue &) = delete;
+
+    void push(ITEM &&item);
+    void push(const ITEM &item);
+    template <typename... ARGS>
+    ITEM &emplace(ARGS &&...args);
+    ITEM &front();
+    const ITEM &front() const;
+    void pop();
+    bool empty() const;
+    size_t size() const;
+    size_t segments() const;
+    size_t freeSegments() const;
+    void trim();
+
+  private:
+    /// @brief Storage for a fixed number of items, aligned to a cache line so that segments do not share cache lines.
+    struct alignas(cacheLineSize) Segment {
+        ITEM *item(size_t index) { return std::launder(reinterpret_cast<ITEM *>(storage + index * sizeof(ITEM))); }
+
+        Segment *next{nullptr};
+        alignas(ITEM) std::byte storage[SEGMENT_ITEMS * sizeof(ITEM)];
+    };
+
+    ITEM *reserve();
+    void release(Segment *segment);
+
+    Segment *head{nullptr};
+    Segment *tail{nullptr};
+    size_t headIndex{0};
+    size_t tailIndex{0};
+    size_t itemCount{0};
+    size_t segmentCount{0};
+    Segment *freeList{nullptr};
+    size_t freeCount{0};
+};
+
+/// @brief Destroy all stored items and release all segments.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline SegmentedQueue<ITEM, SEGMENT_ITEMS>::~SegmentedQueue() {
+    while (!empty()) {
+        pop();
+    }
+
+    delete head;
+    trim();
+}
+
+/// @brief Append an item at the back of the queue.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @param item           Item will be moved into the queue
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline void SegmentedQueue<ITEM, SEGMENT_ITEMS>::push(ITEM &&item) {
+    emplace(std::move(item));
+}
+
+/// @brief Append a copy of an item at the back of the queue.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @param item           Item will be copied into the queue
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline void SegmentedQueue<ITEM, SEGMENT_ITEMS>::push(const ITEM &item) {
+    emplace(item);
+}
+
+/// @brief Construct an item at the back of the queue.
+/// @details If the item constructor throws, the queue is unchanged.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @tparam ...ARGS       Declares template parameter pack of types for the constructor arguments of ITEM
+/// @param ...args        Declares function parameter pack, using forwarding references
+/// @return               Reference to the constructed item
+template <typename ITEM, size_t SEGMENT_ITEMS>
+template <typename... ARGS>
+inline ITEM &SegmentedQueue<ITEM, SEGMENT_ITEMS>::emplace(ARGS &&...args) {
+    auto item = ::new (static_cast<void *>(reserve())) ITEM(std::forward<ARGS>(args)...);
+    tailIndex++;
+    itemCount++;
+    return *item;
+}
+
+/// @brief Access the item at the front of the queue, the queue must not be empty.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @return               Reference to the oldest item
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline ITEM &SegmentedQueue<ITEM, SEGMENT_ITEMS>::front() {
+    return *head->item(headIndex);
+}
+
+/// @brief Access the item at the front of the queue, the queue must not be empty.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @return               Reference to the oldest item
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline const ITEM &SegmentedQueue<ITEM, SEGMENT_ITEMS>::front() const {
+    return *head->item(headIndex);
+}
+
+/// @brief Remove the item at the front of the queue, the queue must not be empty.
+/// @details A drained segment is moved to the free list. The last segment is kept and rewound when the queue becomes empty.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline void SegmentedQueue<ITEM, SEGMENT_ITEMS>::pop() {
+    std::destroy_at(head->item(headIndex));
+    headIndex++;
+    itemCount--;
+
+    if (itemCount == 0) {
+        // an empty queue keeps its tail segment only, which is rewound, the tail can be ahead if an item constructor threw
+        while (head != tail) {
+            release(std::exchange(head, head->next));
+        }
+
+        headIndex = tailIndex = 0;
+    } else if (headIndex == SEGMENT_ITEMS) {
+        auto drained = head;
+        head = head->next;
+        headIndex = 0;
+        release(drained);
+    }
+}
+
+/// @brief Retrieve whether the queue is empty.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @return               The queue holds no items
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline bool SegmentedQueue<ITEM, SEGMENT_ITEMS>::empty() const {
+    return itemCount == 0;
+}
+
+/// @brief Retrieve the number of stored items.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @return               Number of stored items
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline size_t SegmentedQueue<ITEM, SEGMENT_ITEMS>::size() const {
+    return itemCount;
+}
+
+/// @brief Retrieve the number of allocated segments, which is the high-water mark of the queue unless it was trimmed.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @return               Number of segments in use or in the free list
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline size_t SegmentedQueue<ITEM, SEGMENT_ITEMS>::segments() const {
+    return segmentCount;
+}
+
+/// @brief Retrieve the number of segments in the free list.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @return               Number of idle segments that can be trimmed
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline size_t SegmentedQueue<ITEM, SEGMENT_ITEMS>::freeSegments() const {
+    return freeCount;
+}
+
+/// @brief Release all idle segments to the allocator.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline void SegmentedQueue<ITEM, SEGMENT_ITEMS>::trim() {
+    while (freeList != nullptr) {
+        delete std::exchange(freeList, freeList->next);
+        segmentCount--;
+    }
+
+    freeCount = 0;
+}
+
+/// @brief Retrieve uninitialized storage for the next item at the back of the queue.
+/// @details A segment is taken from the free list if the tail segment is full, a new segment is only allocated if the free list is empty.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @return               Storage for the next item
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline ITEM *SegmentedQueue<ITEM, SEGMENT_ITEMS>::reserve() {
+    if (tail == nullptr || tailIndex == SEGMENT_ITEMS) {
+        Segment *segment = nullptr;
+
+        if (freeList != nullptr) {
+            segment = std::exchange(freeList, freeList->next);
+            freeCount--;
+        } else {
+            segment = new Segment;
+            segmentCount++;
+        }
+
+        segment->next = nullptr;
+        (tail == nullptr ? head : tail->next) = segment;
+        tail = segment;
+        tailIndex = 0;
+    }
+
+    return reinterpret_cast<ITEM *>(tail->storage + tailIndex * sizeof(ITEM));
+}
+
+/// @brief Move a drained segment to the free list.
+/// @tparam ITEM          Typename for stored items
+/// @tparam SEGMENT_ITEMS Number of items per segment
+/// @param segment        Segment without items
+template <typename ITEM, size_t SEGMENT_ITEMS>
+inline void SegmentedQueue<ITEM, SEGMENT_ITEMS>::release(Segment *segment) {
+    segment->next = freeList;
+    freeList = segment;
+    freeCount++;
+}
+
+/// @brief Producer-consumer that stores its items in recycled segments instead of a std::deque.
+/// @tparam ITEM   Typename for produced and consumed items
+/// @tparam STATUS Status typename when the producer finishes its work or the consumer cancels its interest
+template <typename ITEM, typename STATUS>
+using SegmentedProducerConsumer = ProducerConsumer<ITEM, STATUS, SegmentedQueue<ITEM>>;
+} // namespace producer_consumer
@@ -4,10 +4,24 @@
 /// @author Michael Petersen
 
 #include <chrono>
+#include <ctime>
+#include <future>
 #include <gtest/gtest.h>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "BatchingConsumer.h"
+#include "ConflatingProducerConsumer.h"
 #include "Logging.h"
+#include "MulticastRing.h"
 #include "ProducerConsumerMock.h"
+#include "SegmentedQueue.h"
 
 using namespace std::chrono_literals;
 using namespace ::testing;
@@ -17,6 +31,19 @@ using namespace producer_consumer;
 namespace worker {
 namespace testing {
 namespace {
+/// @brief Generic consumer that is devirtualized for final producer-consumer types and still accepts mocks.
+template <typename PRODUCER_CONSUMER>
+    requires ProducerConsumerLike<PRODUCER_CONSUMER, int, int>
+int drain(PRODUCER_CONSUMER &producerConsumer) {
+    auto sum = 0;
+
+    for (int item; producerConsumer.consume(&item, 100ms) == ConsumerResult::Available;) {
+        sum += item;
+    }
+
+    return sum;
+}
+
 /// @brief Unit test for the ProducerConsumer class.
 TEST(WorkerSuite, ProducerConsumerTest) {
     // Prepare
@@ -48,6 +75,456 @@ TEST(WorkerSuite, ProducerConsumerTest) {
     EXPECT_EQ(status, -2);
     EXPECT_EQ(count, 2UL);
 }
+
+/// @brief Unit test for generic code that is instantiated with a final producer-consumer type and with a mock.
+TEST(WorkerSuite, ProducerConsumerLikeTest) {
+    // Prepare
+    static_assert(ProducerConsumerLike<ProducerConsumer<int, int>, int, int>);
+    static_assert(ProducerConsumerLike<IProducerConsumer<int, int>, int, int>);
+
+    ProducerConsumer<int, int> producerConsumer;
+    ProducerConsumerMock<int, int> producerConsumerMock;
+
+    EXPECT_CALL(producerConsumerMock, consume)
+        .WillOnce(DoAll(SetArgPointee<0>(5), Return(ConsumerResult::Available)))
+        .WillOnce(Return(ConsumerResult::Finished));
+
+    // Execute
+    producerConsumer.produce(1);
+    producerConsumer.produceAndFinish(2, 0);
+    auto sum = drain(producerConsumer);
+    auto sumMock = drain(producerConsumerMock);
+
+    // Expect
+    EXPECT_EQ(sum, 3);
+    EXPECT_EQ(sumMock, 5);
+}
+
+/// @brief Unit test for the TimerWheel class that expires items across several levels of the wheel.
+TEST(WorkerSuite, TimerWheelTest) {
+    // Prepare
+    TimerWheel<int> wheel;
+    std::vector<int> expired;
+
+    // Execute
+    wheel.insert(3, 5'000'000);
+    wheel.insert(1, 70);
+    wheel.insert(2, 70);
+    wheel.insert(0, 3);
+    auto pending = wheel.size();
+    auto next = wheel.nextEvent();
+
+    wheel.advance(69, [&expired](int &&item) { expired.push_back(item); });
+    auto expiredBefore = expired.size();
+
+    wheel.advance(4'999'999, [&expired](int &&item) { expired.push_back(item); });
+    auto expiredBetween = expired.size();
+
+    wheel.advance(5'000'000, [&expired](int &&item) { expired.push_back(item); });
+
+    // Expect
+    EXPECT_EQ(pending, 4UL);
+    EXPECT_EQ(next, 3UL);
+    EXPECT_EQ(expiredBefore, 1UL);
+    EXPECT_EQ(expiredBetween, 3UL);
+    EXPECT_EQ(expired, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(wheel.size(), 0UL);
+    EXPECT_EQ(wheel.nextEvent(), std::nullopt);
+}
+
+/// @brief Unit test for the DelayedProducerConsumer class.
+TEST(WorkerSuite, DelayedProducerConsumerTest) {
+    // Prepare
+    DelayedProducerConsumer<int, int> producerConsumer;
+
+    // Execute
+    auto producerResult1 = producerConsumer.produceAfter(2, 40ms);
+    auto producerResult2 = producerConsumer.produceAfter(1, 20ms);
+    auto producerResult3 = producerConsumer.produce(0);
+    producerConsumer.finishProducer(-1);
+    auto producerResult4 = producerConsumer.produceAfter(3, 0ms);
+    auto count = producerConsumer.count();
+
+    int item0, item1, item2;
+    auto consumerResult0 = producerConsumer.consume(&item0, 100ms);
+    auto consumerResult1 = producerConsumer.consume(&item1, 1ms);
+    auto consumerResult2 = producerConsumer.consume(&item1, 1s);
+    auto consumerResult3 = producerConsumer.consume(&item2, 1s);
+    auto consumerResult4 = producerConsumer.consume(&item2, 1s);
+
+    // delays at the limits of the steady clock saturate instead of overflowing
+    DelayedProducerConsumer<int, int> limitProducerConsumer;
+    auto producerResult5 = limitProducerConsumer.produceAfter(5, std::chrono::steady_clock::duration::max());
+    auto producerResult6 = limitProducerConsumer.produceAt(6, std::chrono::steady_clock::time_point::max());
+    auto producerResult7 = limitProducerConsumer.produceAfter(7, std::chrono::steady_clock::duration::min());
+    int item3{0};
+    auto consumerResult5 = limitProducerConsumer.tryConsume(&item3);
+    auto consumerResult6 = limitProducerConsumer.tryConsume(&item3);
+
+    // Expect
+    EXPECT_EQ(producerResult1, ProducerResult::Taken);
+    EXPECT_EQ(producerResult2, ProducerResult::Taken);
+    EXPECT_EQ(producerResult3, ProducerResult::Taken);
+    EXPECT_EQ(producerResult4, ProducerResult::Cancelled);
+    EXPECT_EQ(count, 3UL);
+    EXPECT_EQ(consumerResult0, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult1, ConsumerResult::Timeout);
+    EXPECT_EQ(consumerResult2, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult3, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult4, ConsumerResult::Finished);
+    EXPECT_EQ(item0, 0);
+    EXPECT_EQ(item1, 1);
+    EXPECT_EQ(item2, 2);
+    EXPECT_EQ(producerResult5, ProducerResult::Taken);
+    EXPECT_EQ(producerResult6, ProducerResult::Taken);
+    EXPECT_EQ(producerResult7, ProducerResult::Taken);
+    EXPECT_EQ(consumerResult5, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult6, ConsumerResult::Timeout);
+    EXPECT_EQ(item3, 7);
+    EXPECT_EQ(limitProducerConsumer.count(), 2UL);
+}
+
+/// @brief Unit test for a consumer that sleeps on a finished DelayedProducerConsumer until its pending item is due.
+TEST(WorkerSuite, DelayedProducerConsumerFinishedTest) {
+    // Prepare
+    DelayedProducerConsumer<int, int> producerConsumer;
+    producerConsumer.produceAfter(1, 200ms);
+    producerConsumer.finishProducer(0);
+
+    // Execute
+    int item{0};
+    auto cpuStart = std::clock();
+    auto consumerResult1 = producerConsumer.consume(&item, 1s);
+    auto cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    auto consumerResult2 = producerConsumer.consume(&item, 1s);
+
+    // Expect
+    EXPECT_EQ(consumerResult1, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult2, ConsumerResult::Finished);
+    EXPECT_EQ(item, 1);
+    EXPECT_LT(cpuSeconds, 0.1);
+}
+
+/// @brief Unit test for the ConflatingProducerConsumer class.
+TEST(WorkerSuite, ConflatingProducerConsumerTest) {
+    // Prepare
+    using Balance = std::pair<int, double>;
+    ConflatingProducerConsumer<Balance, int, int> producerConsumer{[](const Balance &balance) { return balance.first; }};
+
+    // Execute
+    producerConsumer.produce({1, 100.0});
+    producerConsumer.produce({2, 200.0});
+    producerConsumer.produce({1, 110.0});
+    producerConsumer.produceAndFinish({1, 120.0}, 0);
+    auto count = producerConsumer.count();
+    auto conflated = producerConsumer.conflated();
+
+    Balance balance1, balance2, balance3;
+    auto consumerResult1 = producerConsumer.consume(&balance1, 100ms);
+    auto consumerResult2 = producerConsumer.consume(&balance2, 100ms);
+    auto consumerResult3 = producerConsumer.consume(&balance3, 100ms);
+
+    // Expect
+    EXPECT_EQ(count, 2UL);
+    EXPECT_EQ(conflated, 2UL);
+    EXPECT_EQ(consumerResult1, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult2, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult3, ConsumerResult::Finished);
+    EXPECT_EQ(balance1, Balance(1, 120.0));
+    EXPECT_EQ(balance2, Balance(2, 200.0));
+}
+
+/// @brief Unit test for the MulticastRing class with a dependency between two consumers.
+TEST(WorkerSuite, MulticastRingTest) {
+    // Prepare
+    MulticastRing<int, int> ring{3};
+    auto audit = ring.subscribe();
+    auto business = ring.subscribe({audit});
+
+    // Execute
+    auto producerResult1 = ring.produce(1);
+    auto producerResult2 = ring.produceAndFinish(2, 0);
+    auto capacity = ring.capacity();
+    auto count = ring.count(business);
+
+    const int *auditItem = nullptr;
+    const int *businessItem = nullptr;
+    auto consumerResult1 = ring.consume(business, [&businessItem](const int &item) { businessItem = &item; }, 1ms);
+    auto consumerResult2 = ring.consume(audit, [&auditItem](const int &item) { auditItem = &item; }, 1ms);
+    auto consumerResult3 = ring.consume(business, [&businessItem](const int &item) { businessItem = &item; }, 1ms);
+
+    // Expect
+    EXPECT_EQ(producerResult1, ProducerResult::Taken);
+    EXPECT_EQ(producerResult2, ProducerResult::Taken);
+    EXPECT_EQ(capacity, 4UL);
+    EXPECT_EQ(count, 2UL);
+    EXPECT_EQ(consumerResult1, ConsumerResult::Timeout);
+    EXPECT_EQ(consumerResult2, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult3, ConsumerResult::Available);
+    EXPECT_EQ(*businessItem, 1);
+    EXPECT_EQ(auditItem, businessItem);
+    EXPECT_EQ(ring.count(business), 1UL);
+    EXPECT_THROW(ring.subscribe({business + 1}), std::invalid_argument);
+}
+
+/// @brief Unit test for the MulticastRing class where the producer is gated by concurrent consumers.
+TEST(WorkerSuite, MulticastRingConcurrencyTest) {
+    // Prepare
+    MulticastRing<long, int> ring{8};
+    auto first = ring.subscribe();
+    auto second = ring.subscribe({first});
+    long firstSum = 0, secondSum = 0;
+
+    auto consumer = [&ring](MulticastRing<long, int>::Consumer handle, long &sum) {
+        while (ring.consume(handle, [&sum](const long &item) { sum += item; }) == ConsumerResult::Available) {
+        }
+    };
+
+    // Execute
+    std::thread firstConsumer{consumer, first, std::ref(firstSum)};
+    std::thread secondConsumer{consumer, second, std::ref(secondSum)};
+
+    for (long item = 1; item <= 10'000; item++) {
+        ring.produce(std::move(item));
+    }
+
+    ring.finishProducer(0);
+    firstConsumer.join();
+    secondConsumer.join();
+
+    // Expect
+    EXPECT_EQ(firstSum, 50'005'000L);
+    EXPECT_EQ(secondSum, 50'005'000L);
+}
+
+/// @brief Unit test for constructing items in place and consuming them through borrowed handles.
+TEST(WorkerSuite, ProducerConsumerEmplaceTest) {
+    // Prepare
+    ProducerConsumer<std::string, int> producerConsumer;
+
+    // Execute
+    auto producerResult1 = producerConsumer.emplace(3, 'a');
+    auto producerResult2 = producerConsumer.emplace("bc");
+    producerConsumer.finishProducer(0);
+    auto producerResult3 = producerConsumer.emplace("d");
+
+    std::string item1, item2;
+    auto consumerResult1 = producerConsumer.consumeBorrowed([&item1](std::string &item) { item1 = item; }, 100ms);
+    auto consumerResult2 = producerConsumer.consumeBorrowed([&item2](std::string &item) { item2 = std::move(item); }, 100ms);
+    auto consumerResult3 = producerConsumer.consumeBorrowed([](std::string &) {}, 100ms);
+
+    // the callback runs without the lock, so it can produce into the same instance
+    ProducerConsumer<std::string, int> reentrantProducerConsumer;
+    std::stop_source stopSource;
+    reentrantProducerConsumer.emplace("e");
+    auto reentrantResult = reentrantProducerConsumer.consumeBorrowedUntil(
+        [&reentrantProducerConsumer](std::string &item) { reentrantProducerConsumer.emplace(item + "f"); }, std::chrono::steady_clock::now() + 100ms,
+        stopSource.get_token());
+    BorrowedItem<std::string> borrowed;
+    auto borrowResult1 = reentrantProducerConsumer.borrowUntil(&borrowed, std::chrono::steady_clock::now() + 100ms);
+    auto borrowedItem = *borrowed;
+    stopSource.request_stop();
+    auto borrowResult2 = reentrantProducerConsumer.borrowUntil(&borrowed, std::chrono::steady_clock::time_point::max(), stopSource.get_token());
+
+    // Expect
+    EXPECT_EQ(producerResult1, ProducerResult::Taken);
+    EXPECT_EQ(producerResult2, ProducerResult::Taken);
+    EXPECT_EQ(producerResult3, ProducerResult::Cancelled);
+    EXPECT_EQ(consumerResult1, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult2, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult3, ConsumerResult::Finished);
+    EXPECT_EQ(item1, "aaa");
+    EXPECT_EQ(item2, "bc");
+    EXPECT_EQ(producerConsumer.count(), 0UL);
+    EXPECT_EQ(reentrantResult, ConsumerResult::Available);
+    EXPECT_EQ(borrowResult1, ConsumerResult::Available);
+    EXPECT_EQ(borrowResult2, ConsumerResult::Stopped);
+    EXPECT_EQ(borrowedItem, "ef");
+    EXPECT_FALSE(borrowed);
+}
+
+/// @brief Unit test for deadline-based, non-blocking, and stoppable consumption of producer-consumer instances.
+TEST(WorkerSuite, ProducerConsumerDeadlineTest) {
+    // Prepare
+    ProducerConsumer<int, int> producerConsumer;
+    ProducerConsumer<int, int> spinningProducerConsumer{50us};
+    ConflatingProducerConsumer<int, int, int> conflatingProducerConsumer{[](const int &item) { return item; }};
+    std::stop_source stopSource;
+
+    // Execute
+    int item1{0}, item2{0}, item3{0}, item4{0}, item5{0};
+    auto consumerResult1 = producerConsumer.tryConsume(&item1);
+    auto consumerResult2 = producerConsumer.consumeUntil(&item1, std::chrono::steady_clock::now() + 200us);
+    producerConsumer.produce(1);
+    auto consumerResult3 = producerConsumer.tryConsume(&item1);
+
+    std::jthread producer{[&spinningProducerConsumer] { spinningProducerConsumer.produce(2); }};
+    auto consumerResult4 = spinningProducerConsumer.consume(&item2);
+
+    auto stopped = std::async(std::launch::async, [&producerConsumer, &stopSource, &item3] {
+        return producerConsumer.consumeUntil(&item3, std::chrono::steady_clock::time_point::max(), stopSource.get_token());
+    });
+    auto waiting = std::async(std::launch::async, [&producerConsumer, &item4] { return producerConsumer.consume(&item4, 1s); });
+    std::this_thread::sleep_for(20ms);
+    stopSource.request_stop();
+    auto consumerResult5 = stopped.get();
+    producerConsumer.produce(4);
+    auto consumerResult6 = waiting.get();
+
+    auto consumerResult7 = conflatingProducerConsumer.tryConsume(&item5);
+    conflatingProducerConsumer.produce(5);
+    auto consumerResult8 = conflatingProducerConsumer.consumeUntil(&item5, std::chrono::steady_clock::now() + 1ms, stopSource.get_token());
+
+    // a finished or cancelled queue ends the spin phase of a consumer right away
+    ProducerConsumer<int, int> finishedProducerConsumer{1s};
+    ProducerConsumer<int, int> cancelledProducerConsumer{1s};
+    finishedProducerConsumer.finishProducer(0);
+    auto spinStart = std::chrono::steady_clock::now();
+    auto consumerResult9 = finishedProducerConsumer.consume(&item5, 2s);
+    std::jthread canceller{[&cancelledProducerConsumer] {
+        std::this_thread::sleep_for(20ms);
+        cancelledProducerConsumer.cancelConsumer(0);
+    }};
+    auto consumerResult10 = cancelledProducerConsumer.consume(&item5, 2s);
+    auto spinDuration = std::chrono::steady_clock::now() - spinStart;
+
+    // Expect
+    EXPECT_EQ(consumerResult1, ConsumerResult::Timeout);
+    EXPECT_EQ(consumerResult2, ConsumerResult::Timeout);
+    EXPECT_EQ(consumerResult3, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult4, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult5, ConsumerResult::Stopped);
+    EXPECT_EQ(consumerResult6, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult7, ConsumerResult::Timeout);
+    EXPECT_EQ(consumerResult8, ConsumerResult::Available);
+    EXPECT_EQ(item1, 1);
+    EXPECT_EQ(item2, 2);
+    EXPECT_EQ(item3, 0);
+    EXPECT_EQ(item4, 4);
+    EXPECT_EQ(item5, 5);
+    EXPECT_EQ(consumerResult9, ConsumerResult::Finished);
+    EXPECT_EQ(consumerResult10, ConsumerResult::Finished);
+    EXPECT_LT(spinDuration, 500ms);
+}
+
+/// @brief Unit test for the SegmentedQueue class that recycles its segments and only allocates when its high-water mark grows.
+TEST(WorkerSuite, SegmentedQueueTest) {
+    // Prepare
+    SegmentedQueue<std::string, 4> queue;
+    SegmentedProducerConsumer<std::string, int> producerConsumer;
+
+    // Execute
+    for (auto burst = 0; burst < 3; burst++) {
+        for (auto index = 0; index < 10; index++) {
+            queue.push(std::to_string(index));
+        }
+
+        for (auto index = 0; index < 10; index++) {
+            queue.pop();
+        }
+    }
+
+    auto highWaterMark = queue.segments();
+    queue.emplace(3, 'x');
+    auto front = queue.front();
+    queue.pop();
+    auto idleSegments = queue.freeSegments();
+    queue.trim();
+
+    producerConsumer.emplace(2, 'a');
+    producerConsumer.produce("bc");
+    std::string item1, item2;
+    auto consumerResult1 = producerConsumer.consume(&item1, 100ms);
+    auto consumerResult2 = producerConsumer.tryConsume(&item2);
+    producerConsumer.trim();
+
+    // Expect
+    EXPECT_EQ(highWaterMark, 3UL);
+    EXPECT_EQ(front, "xxx");
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(idleSegments, 2UL);
+    EXPECT_EQ(queue.segments(), 1UL);
+    EXPECT_EQ(queue.freeSegments(), 0UL);
+    EXPECT_EQ(consumerResult1, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult2, ConsumerResult::Available);
+    EXPECT_EQ(item1, "aa");
+    EXPECT_EQ(item2, "bc");
+    EXPECT_EQ(producerConsumer.count(), 0UL);
+}
+
+/// @brief Unit test for the metrics of an instrumented producer-consumer.
+TEST(WorkerSuite, ProducerConsumerMetricsTest) {
+    // Prepare
+    auto &registry = metrics::Registry::instance();
+    auto &produced = registry.counter("producer_consumer_produced_items_total", "", "queue=\"worker_test\"");
+    auto &consumed = registry.counter("producer_consumer_consumed_items_total", "", "queue=\"worker_test\"");
+    auto &queued = registry.gauge("producer_consumer_queued_items", "", "queue=\"worker_test\"");
+    auto producedBefore = produced.value();
+    auto consumedBefore = consumed.value();
+    auto queuedBefore = queued.value();
+    ProducerConsumer<int, int> producerConsumer;
+    auto otherProducerConsumer = std::make_unique<ProducerConsumer<int, int>>();
+    producerConsumer.instrument(registry, "worker_test");
+    otherProducerConsumer->produce(4);
+    otherProducerConsumer->instrument(registry, "worker_test");
+
+    // Execute
+    producerConsumer.produce(1);
+    producerConsumer.emplace(2);
+    producerConsumer.produceAndFinish(3, 0);
+    int item{0};
+    producerConsumer.tryConsume(&item);
+    producerConsumer.consumeBorrowed([](int &) {}, 100ms);
+    otherProducerConsumer->produce(5);
+    auto queuedShared = queued.value() - queuedBefore;
+    otherProducerConsumer.reset();
+    auto queuedRemaining = queued.value() - queuedBefore;
+
+    // Expect
+    EXPECT_EQ(produced.value() - producedBefore, 4UL);
+    EXPECT_EQ(consumed.value() - consumedBefore, 2UL);
+    EXPECT_EQ(queuedShared, 3.0);
+    EXPECT_EQ(queuedRemaining, 1.0);
+}
+
+/// @brief Unit test for the BatchingConsumer class that hands over batches when they are full or when the linger time passed.
+TEST(WorkerSuite, BatchingConsumerTest) {
+    // Prepare
+    ProducerConsumer<int, int> producerConsumer;
+    BatchingConsumer<int, int> batchingConsumer{producerConsumer, 4, 1ms};
+
+    for (auto item = 1; item <= 10; item++) {
+        producerConsumer.produce(std::move(item));
+    }
+
+    // Execute
+    std::vector<size_t> batchSizes;
+    std::vector<int> items;
+    auto collect = [&batchSizes, &items](std::span<int> batch) {
+        batchSizes.push_back(batch.size());
+        items.insert(items.end(), batch.begin(), batch.end());
+    };
+
+    auto consumerResult1 = batchingConsumer.consume(collect, 100ms);
+    auto consumerResult2 = batchingConsumer.consume(collect, 100ms);
+    auto fullLimit = batchingConsumer.batchLimit();
+    auto consumerResult3 = batchingConsumer.consume(collect, 100ms);
+    auto lingerLimit = batchingConsumer.batchLimit();
+    auto consumerResult4 = batchingConsumer.consume(collect, 1ms);
+    producerConsumer.finishProducer(0);
+    auto consumerResult5 = batchingConsumer.consume(collect, 100ms);
+
+    // Expect
+    EXPECT_EQ(consumerResult1, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult2, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult3, ConsumerResult::Available);
+    EXPECT_EQ(consumerResult4, ConsumerResult::Timeout);
+    EXPECT_EQ(consumerResult5, ConsumerResult::Finished);
+    EXPECT_EQ(batchSizes, (std::vector<size_t>{4, 4, 2}));
+    EXPECT_EQ(items, (std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    EXPECT_EQ(fullLimit, 4UL);
+    EXPECT_EQ(lingerLimit, 3UL);
+}
 } // namespace
 } // namespace testing
 } // namespace worker
\ No newline at end of file